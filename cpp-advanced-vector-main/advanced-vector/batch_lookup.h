@@ -0,0 +1,135 @@
+#pragma once
+
+#include "span.h"
+#include "vector.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+
+namespace detail {
+
+// Подсказка процессору загрузить строку кеша заранее
+template <typename T>
+inline void Prefetch(const T* address) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(address);
+#else
+    (void)address;
+#endif
+}
+
+template <typename T>
+inline void PrefetchForWrite(T* address) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(address, 1);
+#else
+    (void)address;
+#endif
+}
+
+// Сколько запросов продвигается одновременно: столько промахов кеша
+// может быть в полёте, а состояние группы помещается в регистры и L1
+constexpr size_t kBatchLanes = 16;
+
+// На сколько элементов вперёд выполняется предвыборка при сборке
+constexpr size_t kGatherDistance = 16;
+
+}  // namespace detail
+
+// Пакетный поиск: out[i] - позиция первого элемента sorted, не меньшего
+// keys[i]. Группа запросов выполняет двоичный поиск без ветвлений шаг
+// в шаг, и перед каждым шагом для всех запросов группы запрашиваются обе
+// возможные следующие точки сравнения
+template <typename T>
+void LowerBoundBatch(Span<const T> sorted, Span<const detail::NonDeduced<T>> keys, Span<size_t> out) {
+    assert(keys.Size() == out.Size());
+    const T* data = sorted.Data();
+    for (size_t begin = 0; begin < keys.Size(); begin += detail::kBatchLanes) {
+        const size_t count = std::min(detail::kBatchLanes, keys.Size() - begin);
+        size_t base[detail::kBatchLanes] = {};
+        if (sorted.Size() == 0) {
+            std::fill(out.begin() + begin, out.begin() + begin + count, size_t{0});
+            continue;
+        }
+        for (size_t length = sorted.Size(); length > 1;) {
+            const size_t half = length / 2;
+            const size_t next_half = (length - half) / 2;
+            for (size_t i = 0; i < count; ++i) {
+                detail::Prefetch(data + base[i] + next_half);
+                detail::Prefetch(data + base[i] + half + next_half);
+                base[i] += data[base[i] + half] < keys[begin + i] ? half : 0;
+            }
+            length -= half;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            out[begin + i] = base[i] + static_cast<size_t>(data[base[i]] < keys[begin + i]);
+        }
+    }
+}
+
+// Перегрузка для Vector: Span<const T> не выводится из аргумента Vector<T>
+template <typename T>
+void LowerBoundBatch(const Vector<T>& sorted, Span<const detail::NonDeduced<T>> keys, Span<size_t> out) {
+    LowerBoundBatch(Span<const T>(sorted), keys, out);
+}
+
+// Пакетная выборка out[i] = source[indices[i]] с предвыборкой элементов,
+// которые понадобятся через kGatherDistance шагов
+template <typename T, typename Index>
+void Gather(Span<const T> source, Span<const Index> indices, Span<detail::NonDeduced<T>> out) {
+    assert(indices.Size() == out.Size());
+    const size_t count = indices.Size();
+    for (size_t i = 0; i < count; ++i) {
+        if (i + detail::kGatherDistance < count) {
+            detail::Prefetch(source.Data() + indices[i + detail::kGatherDistance]);
+        }
+        out[i] = source[indices[i]];
+    }
+}
+
+// То же с новым Vector: элементы копируются сразу в зарезервированную
+// ёмкость, без предварительного создания значений по умолчанию
+template <typename T, typename Index>
+Vector<T> Gather(Span<const T> source, Span<const Index> indices) {
+    const size_t count = indices.Size();
+    Vector<T> out;
+    out.Reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        if (i + detail::kGatherDistance < count) {
+            detail::Prefetch(source.Data() + indices[i + detail::kGatherDistance]);
+        }
+        out.PushBack(source[indices[i]]);
+    }
+    return out;
+}
+
+// Пакетная запись destination[indices[i]] = source[i]; строки кеша
+// будущих записей запрашиваются заранее
+template <typename T, typename Index>
+void Scatter(Span<const T> source, Span<const Index> indices, Span<detail::NonDeduced<T>> destination) {
+    assert(source.Size() == indices.Size());
+    const size_t count = indices.Size();
+    for (size_t i = 0; i < count; ++i) {
+        if (i + detail::kGatherDistance < count) {
+            detail::PrefetchForWrite(destination.Data() + indices[i + detail::kGatherDistance]);
+        }
+        destination[indices[i]] = source[i];
+    }
+}
+
+// Перегрузки для Vector: Span<const T> не выводится из аргумента Vector<T>
+template <typename T, typename Index>
+void Gather(const Vector<T>& source, const Vector<Index>& indices, Span<detail::NonDeduced<T>> out) {
+    Gather(Span<const T>(source), Span<const Index>(indices), out);
+}
+
+template <typename T, typename Index>
+Vector<T> Gather(const Vector<T>& source, const Vector<Index>& indices) {
+    return Gather(Span<const T>(source), Span<const Index>(indices));
+}
+
+template <typename T, typename Index>
+void Scatter(const Vector<T>& source, const Vector<Index>& indices, Span<detail::NonDeduced<T>> destination) {
+    Scatter(Span<const T>(source), Span<const Index>(indices), destination);
+}
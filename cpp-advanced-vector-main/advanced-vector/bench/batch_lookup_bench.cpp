@@ -0,0 +1,93 @@
+// Пропускная способность пакетных запросов в зависимости от размера
+// пакета: LowerBoundBatch, FlatHashMap::FindBatch и Gather на данных
+// много больше кеша. Размер 1 - поиск по одному ключу за вызов; внутри
+// вызова одновременно продвигается до detail::kBatchLanes запросов.
+// g++ -std=c++17 -O2 -DNDEBUG bench/batch_lookup_bench.cpp -o batch_lookup_bench
+#include "../batch_lookup.h"
+#include "../flat_hash_map.h"
+#include "../vector.h"
+#include "bench.h"
+
+#include <algorithm>
+#include <string>
+
+namespace {
+
+constexpr size_t kSize = 1 << 24;
+constexpr size_t kQueries = 1 << 20;
+constexpr size_t kBatchSizes[] = {1, 2, 4, 8, 16, 64, 1024};
+
+std::string WithBatch(const char* name, size_t batch) {
+    return std::string(name) + " batch=" + std::to_string(batch);
+}
+
+}  // namespace
+
+int main() {
+    uint64_t state = 11;
+    Vector<uint64_t> sorted;
+    for (size_t i = 0; i < kSize; ++i) {
+        sorted.PushBack(bench::NextRandom(state));
+    }
+    std::sort(sorted.begin(), sorted.end());
+    Vector<uint64_t> queries;
+    Vector<uint32_t> indices;
+    for (size_t i = 0; i < kQueries; ++i) {
+        queries.PushBack(sorted[bench::NextRandom(state) % kSize]);
+        indices.PushBack(static_cast<uint32_t>(bench::NextRandom(state) % kSize));
+    }
+    FlatHashMap<uint64_t, uint64_t> map;
+    map.Reserve(kSize);
+    for (const uint64_t key : sorted) {
+        map.Insert(key, key);
+    }
+
+    Vector<size_t> positions(kQueries);
+    Vector<uint64_t*> values(kQueries);
+    Vector<uint64_t> gathered(kQueries);
+
+    bench::Report("std::lower_bound", kSize, bench::NsPerOp(kQueries, [&] {
+        uint64_t sum = 0;
+        for (const uint64_t key : queries) {
+            sum += std::lower_bound(sorted.begin(), sorted.end(), key) - sorted.begin();
+        }
+        return sum;
+    }));
+    for (const size_t batch : kBatchSizes) {
+        bench::Report(WithBatch("LowerBoundBatch", batch).c_str(), kSize, bench::NsPerOp(kQueries, [&] {
+            for (size_t i = 0; i < kQueries; i += batch) {
+                LowerBoundBatch(sorted, Span<const uint64_t>(queries).Subspan(i, batch),
+                                Span<size_t>(positions).Subspan(i, batch));
+            }
+            return positions[kQueries - 1];
+        }));
+    }
+
+    bench::Report("FlatHashMap::Find", kSize, bench::NsPerOp(kQueries, [&] {
+        uint64_t sum = 0;
+        for (const uint64_t key : queries) {
+            sum += *map.Find(key);
+        }
+        return sum;
+    }));
+    for (const size_t batch : kBatchSizes) {
+        bench::Report(WithBatch("FlatHashMap::FindBatch", batch).c_str(), kSize, bench::NsPerOp(kQueries, [&] {
+            for (size_t i = 0; i < kQueries; i += batch) {
+                map.FindBatch(Span<const uint64_t>(queries).Subspan(i, batch),
+                              Span<uint64_t*>(values).Subspan(i, batch));
+            }
+            return *values[kQueries - 1];
+        }));
+    }
+
+    bench::Report("indexed loop", kSize, bench::NsPerOp(kQueries, [&] {
+        for (size_t i = 0; i < kQueries; ++i) {
+            gathered[i] = sorted[indices[i]];
+        }
+        return gathered[kQueries - 1];
+    }));
+    bench::Report("Gather", kSize, bench::NsPerOp(kQueries, [&] {
+        Gather(sorted, indices, gathered);
+        return gathered[kQueries - 1];
+    }));
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+
+// Минимальный замер для сравнения структур данных: лучший из нескольких
+// прогонов, время в наносекундах на операцию. Прогон возвращает
+// контрольную сумму, чтобы компилятор не выбросил вычисления
+namespace bench {
+
+inline volatile uint64_t checksum_sink = 0;
+
+template <typename Func>
+double NsPerOp(size_t operations, Func func, int repeats = 5) {
+    double best = 0;
+    for (int repeat = 0; repeat < repeats; ++repeat) {
+        const auto start = std::chrono::steady_clock::now();
+        const uint64_t checksum = func();
+        const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        checksum_sink = checksum_sink + checksum;
+        const double ns = elapsed.count() / static_cast<double>(operations);
+        best = repeat == 0 ? ns : std::min(best, ns);
+    }
+    return best;
+}
+
+// То же, но перед каждым прогоном setup() готовит данные, и время его
+// работы не учитывается. func получает результат setup() по ссылке
+template <typename Setup, typename Func>
+double NsPerOpAfter(size_t operations, Setup setup, Func func, int repeats = 5) {
+    double best = 0;
+    for (int repeat = 0; repeat < repeats; ++repeat) {
+        auto state = setup();
+        const auto start = std::chrono::steady_clock::now();
+        const uint64_t checksum = func(state);
+        const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        checksum_sink = checksum_sink + checksum;
+        const double ns = elapsed.count() / static_cast<double>(operations);
+        best = repeat == 0 ? ns : std::min(best, ns);
+    }
+    return best;
+}
+
+inline void Report(const char* name, size_t size, double ns_per_op) {
+    std::printf("%-36s %10zu %9.2f ns/op\n", name, size, ns_per_op);
+}
+
+// Псевдослучайная последовательность для входных данных
+inline uint64_t NextRandom(uint64_t& state) noexcept {
+    state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+    return state >> 11;
+}
+
+}  // namespace bench
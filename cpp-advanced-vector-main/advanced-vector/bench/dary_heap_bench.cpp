@@ -0,0 +1,83 @@
+// Push всех элементов и Pop до опустошения: std::priority_queue против
+// DaryHeap с арностью 2, 4 и 8; отдельно - построение PushRange.
+// g++ -std=c++17 -O2 -DNDEBUG bench/dary_heap_bench.cpp -o dary_heap_bench
+#include "../dary_heap.h"
+#include "../vector.h"
+#include "bench.h"
+
+#include <queue>
+#include <vector>
+
+namespace {
+
+template <typename Heap>
+uint64_t PushPopAll(const Vector<uint64_t>& values) {
+    Heap heap;
+    for (const uint64_t value : values) {
+        heap.Push(value);
+    }
+    uint64_t checksum = 0;
+    while (!heap.Empty()) {
+        checksum = checksum * 31 + heap.Top();
+        heap.Pop();
+    }
+    return checksum;
+}
+
+uint64_t StdPushPopAll(const Vector<uint64_t>& values) {
+    std::priority_queue<uint64_t> heap;
+    for (const uint64_t value : values) {
+        heap.push(value);
+    }
+    uint64_t checksum = 0;
+    while (!heap.empty()) {
+        checksum = checksum * 31 + heap.top();
+        heap.pop();
+    }
+    return checksum;
+}
+
+template <size_t D>
+uint64_t BuildAndPop(const Vector<uint64_t>& values) {
+    DaryHeap<uint64_t, D> heap;
+    heap.PushRange(values);
+    return heap.Top();
+}
+
+void Run(size_t size) {
+    Vector<uint64_t> values;
+    uint64_t state = 3;
+    for (size_t i = 0; i < size; ++i) {
+        values.PushBack(bench::NextRandom(state));
+    }
+    // Операция - одна пара Push и Pop
+    bench::Report("std::priority_queue push+pop", size, bench::NsPerOp(size, [&values] {
+        return StdPushPopAll(values);
+    }));
+    bench::Report("DaryHeap<2> push+pop", size, bench::NsPerOp(size, [&values] {
+        return PushPopAll<DaryHeap<uint64_t, 2>>(values);
+    }));
+    bench::Report("DaryHeap<4> push+pop", size, bench::NsPerOp(size, [&values] {
+        return PushPopAll<DaryHeap<uint64_t, 4>>(values);
+    }));
+    bench::Report("DaryHeap<8> push+pop", size, bench::NsPerOp(size, [&values] {
+        return PushPopAll<DaryHeap<uint64_t, 8>>(values);
+    }));
+    // Операция - один элемент пачки
+    bench::Report("std::make_heap", size, bench::NsPerOp(size, [&values] {
+        std::vector<uint64_t> heap(values.begin(), values.end());
+        std::make_heap(heap.begin(), heap.end());
+        return heap.front();
+    }));
+    bench::Report("DaryHeap<4>::PushRange", size, bench::NsPerOp(size, [&values] {
+        return BuildAndPop<4>(values);
+    }));
+}
+
+}  // namespace
+
+int main() {
+    for (size_t size : {size_t{1'000}, size_t{100'000}, size_t{4'000'000}}) {
+        Run(size);
+    }
+}
@@ -0,0 +1,59 @@
+// Поиск LowerBound по случайным ключам в отсортированном массиве uint64_t:
+// std::lower_bound против EytzingerIndex (BlockSize 1 и 8) от размеров,
+// помещающихся в L1, до размеров много больше кеша.
+// g++ -std=c++17 -O2 -DNDEBUG bench/eytzinger_index_bench.cpp -o eytzinger_index_bench
+#include "../eytzinger_index.h"
+#include "../vector.h"
+#include "bench.h"
+
+#include <algorithm>
+
+namespace {
+
+constexpr size_t kQueries = 1 << 20;
+
+void Run(size_t size) {
+    Vector<uint64_t> sorted;
+    uint64_t state = 9;
+    for (size_t i = 0; i < size; ++i) {
+        sorted.PushBack(bench::NextRandom(state));
+    }
+    std::sort(sorted.begin(), sorted.end());
+    Vector<uint64_t> queries;
+    for (size_t i = 0; i < kQueries; ++i) {
+        queries.PushBack(bench::NextRandom(state));
+    }
+    const EytzingerIndex<uint64_t> eytzinger(sorted);
+    const EytzingerIndex<uint64_t, 8> btree(sorted);
+
+    bench::Report("std::lower_bound", size, bench::NsPerOp(kQueries, [&] {
+        uint64_t sum = 0;
+        for (const uint64_t key : queries) {
+            sum += std::lower_bound(sorted.begin(), sorted.end(), key) - sorted.begin();
+        }
+        return sum;
+    }));
+    bench::Report("EytzingerIndex<1>::LowerBound", size, bench::NsPerOp(kQueries, [&] {
+        uint64_t sum = 0;
+        for (const uint64_t key : queries) {
+            sum += eytzinger.LowerBound(key);
+        }
+        return sum;
+    }));
+    bench::Report("EytzingerIndex<8>::LowerBound", size, bench::NsPerOp(kQueries, [&] {
+        uint64_t sum = 0;
+        for (const uint64_t key : queries) {
+            sum += btree.LowerBound(key);
+        }
+        return sum;
+    }));
+}
+
+}  // namespace
+
+int main() {
+    // 4 КБ (L1), 256 КБ (L2), 8 МБ (L3), 256 МБ (память)
+    for (size_t size : {size_t{512}, size_t{32'768}, size_t{1'048'576}, size_t{33'554'432}}) {
+        Run(size);
+    }
+}
@@ -0,0 +1,105 @@
+// Вставка, поиск (попадания и промахи) и удаление uint64_t ключей:
+// std::unordered_map против FlatHashMap при разной заполненности таблицы.
+// Ёмкость FlatHashMap фиксирована заранее, поэтому вставка идёт без
+// перестроений и заполненность определяется числом ключей.
+// g++ -std=c++17 -O2 -DNDEBUG bench/flat_hash_map_bench.cpp -o flat_hash_map_bench
+#include "../flat_hash_map.h"
+#include "../vector.h"
+#include "bench.h"
+
+#include <string>
+#include <unordered_map>
+
+namespace {
+
+constexpr size_t kReserve = 1 << 20;
+
+void Run(double load) {
+    const size_t capacity = [] {
+        FlatHashMap<uint64_t, uint64_t> probe;
+        probe.Reserve(kReserve);
+        return probe.Capacity();
+    }();
+    const size_t size = static_cast<size_t>(static_cast<double>(capacity) * load);
+    Vector<uint64_t> keys;
+    Vector<uint64_t> missing;
+    uint64_t state = 5;
+    for (size_t i = 0; i < size; ++i) {
+        keys.PushBack(bench::NextRandom(state) | 1);
+        missing.PushBack(bench::NextRandom(state) & ~uint64_t{1});
+    }
+    const std::string suffix = " @" + std::to_string(static_cast<int>(load * 100)) + "%";
+    const auto report = [&suffix, size](const char* name, double ns) {
+        bench::Report((name + suffix).c_str(), size, ns);
+    };
+
+    FlatHashMap<uint64_t, uint64_t> flat;
+    std::unordered_map<uint64_t, uint64_t> node;
+    report("FlatHashMap insert", bench::NsPerOp(size, [&] {
+        flat = FlatHashMap<uint64_t, uint64_t>();
+        flat.Reserve(kReserve);
+        for (const uint64_t key : keys) {
+            flat.Insert(key, key);
+        }
+        return flat.Size();
+    }));
+    report("unordered_map insert", bench::NsPerOp(size, [&] {
+        node = std::unordered_map<uint64_t, uint64_t>();
+        node.reserve(size);
+        for (const uint64_t key : keys) {
+            node.emplace(key, key);
+        }
+        return node.size();
+    }));
+    report("FlatHashMap find hit", bench::NsPerOp(size, [&] {
+        uint64_t sum = 0;
+        for (const uint64_t key : keys) {
+            sum += *flat.Find(key);
+        }
+        return sum;
+    }));
+    report("unordered_map find hit", bench::NsPerOp(size, [&] {
+        uint64_t sum = 0;
+        for (const uint64_t key : keys) {
+            sum += node.find(key)->second;
+        }
+        return sum;
+    }));
+    report("FlatHashMap find miss", bench::NsPerOp(size, [&] {
+        uint64_t found = 0;
+        for (const uint64_t key : missing) {
+            found += flat.Contains(key);
+        }
+        return found;
+    }));
+    report("unordered_map find miss", bench::NsPerOp(size, [&] {
+        uint64_t found = 0;
+        for (const uint64_t key : missing) {
+            found += node.count(key);
+        }
+        return found;
+    }));
+    // Удаление разрушает таблицу, поэтому замер один
+    report("FlatHashMap erase", bench::NsPerOp(size, [&] {
+        uint64_t erased = 0;
+        for (const uint64_t key : keys) {
+            erased += flat.Erase(key);
+        }
+        return erased;
+    }, 1));
+    report("unordered_map erase", bench::NsPerOp(size, [&] {
+        uint64_t erased = 0;
+        for (const uint64_t key : keys) {
+            erased += node.erase(key);
+        }
+        return erased;
+    }, 1));
+}
+
+}  // namespace
+
+int main() {
+    for (double load : {0.25, 0.5, 0.75, 0.85}) {
+        Run(load);
+    }
+}
@@ -0,0 +1,101 @@
+// Пул объектов с удалениями: Hive против Vector с Erase и std::list.
+// Фазы: вставка size элементов, удаление каждого второго, проход по
+// оставшимся и повторная вставка size / 2 элементов на место удалённых.
+// g++ -std=c++17 -O2 -DNDEBUG bench/hive_bench.cpp -o hive_bench
+#include "../hive.h"
+#include "../vector.h"
+#include "bench.h"
+
+#include <list>
+#include <string>
+
+namespace {
+
+struct Object {
+    uint64_t id;
+    uint64_t payload[3];
+};
+
+template <typename Container>
+uint64_t SumIds(const Container& objects) {
+    uint64_t sum = 0;
+    for (const Object& object : objects) {
+        sum += object.id;
+    }
+    return sum;
+}
+
+template <typename Container, typename Insert, typename EraseHalf>
+void Run(const char* name, size_t size, Insert insert, EraseHalf erase_half, int repeats) {
+    const auto report = [name, size](const char* phase, double ns) {
+        bench::Report((std::string(name) + " " + phase).c_str(), size, ns);
+    };
+    const auto insert_n = [&insert](Container& objects, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            insert(objects, Object{i, {}});
+        }
+        return SumIds(objects);
+    };
+    const auto empty = [] {
+        return Container();
+    };
+    const auto filled = [&insert_n, size] {
+        Container objects;
+        insert_n(objects, size);
+        return objects;
+    };
+    const auto half_erased = [&filled, &erase_half] {
+        Container objects = filled();
+        erase_half(objects);
+        return objects;
+    };
+
+    report("insert", bench::NsPerOpAfter(size, empty, [&insert_n, size](Container& objects) {
+        return insert_n(objects, size);
+    }, repeats));
+    report("erase every 2nd", bench::NsPerOpAfter(size / 2, filled, [&erase_half](Container& objects) {
+        erase_half(objects);
+        return SumIds(objects);
+    }, repeats));
+    report("iterate", bench::NsPerOpAfter(size / 2, half_erased, [](const Container& objects) {
+        return SumIds(objects);
+    }, repeats));
+    report("reinsert", bench::NsPerOpAfter(size / 2, half_erased, [&insert_n, size](Container& objects) {
+        return insert_n(objects, size / 2);
+    }, repeats));
+}
+
+}  // namespace
+
+int main() {
+    for (size_t size : {size_t{10'000}, size_t{100'000}}) {
+        Run<Hive<Object>>("Hive", size, [](Hive<Object>& hive, const Object& object) {
+            hive.Insert(object);
+        }, [](Hive<Object>& hive) {
+            for (auto it = hive.begin(); it != hive.end();) {
+                it = hive.Erase(it);
+                if (it != hive.end()) {
+                    ++it;
+                }
+            }
+        }, 5);
+        Run<std::list<Object>>("std::list", size, [](std::list<Object>& list, const Object& object) {
+            list.push_back(object);
+        }, [](std::list<Object>& list) {
+            for (auto it = list.begin(); it != list.end();) {
+                it = list.erase(it);
+                if (it != list.end()) {
+                    ++it;
+                }
+            }
+        }, 5);
+        // Каждое удаление сдвигает хвост, поэтому большой размер замеряется один раз
+        Run<Vector<Object>>("Vector", size, [](Vector<Object>& vector, const Object& object) {
+            vector.PushBack(object);
+        }, [](Vector<Object>& vector) {
+            for (size_t i = 0; i < vector.Size(); ++i) {
+                vector.Erase(vector.begin() + i);
+            }
+        }, size > 10'000 ? 1 : 5);
+    }
+}
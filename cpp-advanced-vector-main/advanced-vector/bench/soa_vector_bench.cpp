@@ -0,0 +1,76 @@
+// Проход по двум из двенадцати полей: Vector структур против SoAVector.
+// g++ -std=c++17 -O2 -DNDEBUG bench/soa_vector_bench.cpp -o soa_vector_bench
+#include "../soa_vector.h"
+#include "../vector.h"
+#include "bench.h"
+
+namespace {
+
+struct Order {
+    uint64_t id;
+    double price;
+    double quantity;
+    uint64_t client;
+    uint64_t instrument;
+    uint64_t created;
+    uint64_t updated;
+    uint32_t flags;
+    uint32_t venue;
+    double fee;
+    double limit;
+    uint64_t parent;
+};
+
+using OrderColumns = SoAVector<uint64_t, double, double, uint64_t, uint64_t, uint64_t, uint64_t, uint32_t,
+                               uint32_t, double, double, uint64_t>;
+
+void Run(size_t size) {
+    Vector<Order> rows;
+    OrderColumns columns;
+    rows.Reserve(size);
+    columns.Reserve(size);
+    uint64_t state = 1;
+    for (size_t i = 0; i < size; ++i) {
+        const double price = static_cast<double>(bench::NextRandom(state) % 10000) / 100;
+        const double quantity = static_cast<double>(bench::NextRandom(state) % 100);
+        rows.PushBack(Order{i, price, quantity, 0, 0, 0, 0, 0, 0, 0, 0, 0});
+        columns.EmplaceBack(i, price, quantity, uint64_t{0}, uint64_t{0}, uint64_t{0}, uint64_t{0}, uint32_t{0},
+                            uint32_t{0}, 0.0, 0.0, uint64_t{0});
+    }
+
+    const double aos = bench::NsPerOp(size, [&rows] {
+        double notional = 0;
+        for (const Order& order : rows) {
+            notional += order.price * order.quantity;
+        }
+        return static_cast<uint64_t>(notional);
+    });
+    const double soa = bench::NsPerOp(size, [&columns] {
+        const auto prices = columns.Column<1>();
+        const auto quantities = columns.Column<2>();
+        double notional = 0;
+        for (size_t i = 0; i < prices.Size(); ++i) {
+            notional += prices[i] * quantities[i];
+        }
+        return static_cast<uint64_t>(notional);
+    });
+    const double proxy = bench::NsPerOp(size, [&columns] {
+        double notional = 0;
+        for (size_t i = 0; i < columns.Size(); ++i) {
+            const auto row = columns[i];
+            notional += std::get<1>(row) * std::get<2>(row);
+        }
+        return static_cast<uint64_t>(notional);
+    });
+    bench::Report("Vector<Order> scan", size, aos);
+    bench::Report("SoAVector column scan", size, soa);
+    bench::Report("SoAVector row proxy scan", size, proxy);
+}
+
+}  // namespace
+
+int main() {
+    for (size_t size : {size_t{1'000}, size_t{100'000}, size_t{4'000'000}}) {
+        Run(size);
+    }
+}
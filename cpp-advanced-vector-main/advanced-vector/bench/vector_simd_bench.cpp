@@ -0,0 +1,89 @@
+// Ядра vector_simd по каждому варианту набора инструкций против
+// стандартных алгоритмов на массивах int32_t и float в L2.
+// g++ -std=c++17 -O2 -DNDEBUG bench/vector_simd_bench.cpp -o vector_simd_bench
+#include "../vector.h"
+#include "../vector_simd.h"
+#include "bench.h"
+
+#include <algorithm>
+#include <numeric>
+#include <string>
+
+namespace {
+
+constexpr size_t kSize = 64 * 1024;
+
+const char* IsaName(simd::Isa isa) {
+    switch (isa) {
+        case simd::Isa::kAvx512:
+            return "avx512";
+        case simd::Isa::kAvx2:
+            return "avx2";
+        case simd::Isa::kBaseline:
+            break;
+    }
+    return "baseline";
+}
+
+template <typename T>
+void Run(const char* type) {
+    Vector<T> values(kSize);
+    for (size_t i = 0; i < kSize; ++i) {
+        values[i] = static_cast<T>(i % 1000);
+    }
+    Vector<T> copy = values;
+    // Искомое значение - последний элемент: поиск проходит весь массив
+    const T needle = static_cast<T>(-1);
+    values[kSize - 1] = needle;
+    copy[kSize - 1] = needle;
+
+    const auto report = [type](const std::string& name, double ns) {
+        bench::Report((name + " " + type).c_str(), kSize, ns);
+    };
+    report("std::find", bench::NsPerOp(kSize, [&] {
+        return static_cast<uint64_t>(std::find(values.begin(), values.end(), needle) - values.begin());
+    }));
+    report("std::count", bench::NsPerOp(kSize, [&] {
+        return static_cast<uint64_t>(std::count(values.begin(), values.end(), needle));
+    }));
+    report("std::minmax_element", bench::NsPerOp(kSize, [&] {
+        const auto [min, max] = std::minmax_element(values.begin(), values.end());
+        return static_cast<uint64_t>(*max - *min);
+    }));
+    report("std::accumulate", bench::NsPerOp(kSize, [&] {
+        return static_cast<uint64_t>(std::accumulate(values.begin(), values.end(), simd::detail::SumType<T>{}));
+    }));
+    report("std::equal", bench::NsPerOp(kSize, [&] {
+        return static_cast<uint64_t>(std::equal(values.begin(), values.end(), copy.begin()));
+    }));
+
+    for (const simd::Isa isa : {simd::Isa::kBaseline, simd::Isa::kAvx2, simd::Isa::kAvx512}) {
+        if (!simd::Supports(isa)) {
+            continue;
+        }
+        const std::string suffix = std::string(" ") + IsaName(isa);
+        report("simd::Find" + suffix, bench::NsPerOp(kSize, [&] {
+            return static_cast<uint64_t>(simd::Find(values, needle, isa));
+        }));
+        report("simd::Count" + suffix, bench::NsPerOp(kSize, [&] {
+            return static_cast<uint64_t>(simd::Count(values, needle, isa));
+        }));
+        report("simd::MinMax" + suffix, bench::NsPerOp(kSize, [&] {
+            const auto [min, max] = simd::MinMax(values, isa);
+            return static_cast<uint64_t>(max - min);
+        }));
+        report("simd::Sum" + suffix, bench::NsPerOp(kSize, [&] {
+            return static_cast<uint64_t>(simd::Sum(values, isa));
+        }));
+        report("simd::Equal" + suffix, bench::NsPerOp(kSize, [&] {
+            return static_cast<uint64_t>(simd::Equal(values, copy, isa));
+        }));
+    }
+}
+
+}  // namespace
+
+int main() {
+    Run<int32_t>("int32_t");
+    Run<float>("float");
+}
@@ -0,0 +1,399 @@
+#pragma once
+
+#include "vector.h"
+#include "vector_simd.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+
+#if VECTOR_SIMD_DISPATCH
+#include <immintrin.h>
+#endif
+
+namespace detail {
+
+inline unsigned PopCount(uint64_t word) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_popcountll(word));
+#else
+    word = word - ((word >> 1) & 0x5555555555555555ULL);
+    word = (word & 0x3333333333333333ULL) + ((word >> 2) & 0x3333333333333333ULL);
+    word = (word + (word >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+    return static_cast<unsigned>((word * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+// word не должно быть нулём
+inline unsigned CountTrailingZeros(uint64_t word) noexcept {
+    assert(word != 0);
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_ctzll(word));
+#else
+    return PopCount((word & (~word + 1)) - 1);
+#endif
+}
+
+// Позиция k-го (с нуля) установленного бита в слове
+inline unsigned SelectInWord(uint64_t word, unsigned k) noexcept {
+    assert(k < PopCount(word));
+    for (; k > 0; --k) {
+        word &= word - 1;
+    }
+    return CountTrailingZeros(word);
+}
+
+// Слов в блоке индекса ранга: 512 бит, один регистр AVX-512
+constexpr size_t kRankBlockWords = 8;
+
+// Пословные ядра для simd::detail::Run: в вариантах AVX2 и AVX-512
+// PopCount становится инструкцией POPCNT, а не вызовом библиотеки
+struct PopCountKernel {
+    VECTOR_SIMD_INLINE static size_t Run(const uint64_t* words, size_t count) noexcept {
+        size_t total = 0;
+        for (size_t i = 0; i < count; ++i) {
+            total += PopCount(words[i]);
+        }
+        return total;
+    }
+};
+
+// rank[b] - число единиц в блоках до b, последний элемент - всего
+struct RankKernel {
+    VECTOR_SIMD_INLINE static void Run(const uint64_t* words, size_t count, uint64_t* rank) noexcept {
+        uint64_t total = 0;
+        for (size_t begin = 0; begin < count; begin += kRankBlockWords) {
+            rank[begin / kRankBlockWords] = total;
+            for (size_t i = begin, end = std::min(begin + kRankBlockWords, count); i < end; ++i) {
+                total += PopCount(words[i]);
+            }
+        }
+        rank[(count + kRankBlockWords - 1) / kRankBlockWords] = total;
+    }
+};
+
+struct CombineKernel {
+    template <typename Operation>
+    VECTOR_SIMD_INLINE static void Run(uint64_t* lhs, const uint64_t* rhs, size_t count,
+                                       Operation operation) noexcept {
+        for (size_t i = 0; i < count; ++i) {
+            lhs[i] = operation(lhs[i], rhs[i]);
+        }
+    }
+};
+
+#if VECTOR_SIMD_DISPATCH
+// VPOPCNTDQ есть не у всех процессоров с AVX-512
+inline bool HasVectorPopCount() noexcept {
+    static const bool has = simd::Supports(simd::Isa::kAvx512) && __builtin_cpu_supports("avx512vpopcntdq");
+    return has;
+}
+
+// Сумма восьми 64-битных полос. _mm512_reduce_add_epi64 в GCC 12
+// даёт ложное предупреждение -Wuninitialized
+__attribute__((target("avx512f"))) inline uint64_t SumLanes(__m512i lanes) noexcept {
+    uint64_t values[kRankBlockWords];
+    _mm512_storeu_si512(values, lanes);
+    uint64_t sum = 0;
+    for (const uint64_t value : values) {
+        sum += value;
+    }
+    return sum;
+}
+
+// Подсчёт по 8 слов за инструкцию
+__attribute__((target("avx512f,avx512vpopcntdq,popcnt"))) inline size_t PopCountVpopcntdq(
+    const uint64_t* words, size_t count) noexcept {
+    __m512i sums = _mm512_setzero_si512();
+    size_t i = 0;
+    for (; i + kRankBlockWords <= count; i += kRankBlockWords) {
+        sums = _mm512_add_epi64(sums, _mm512_popcnt_epi64(_mm512_loadu_si512(words + i)));
+    }
+    size_t total = SumLanes(sums);
+    for (; i < count; ++i) {
+        total += PopCount(words[i]);
+    }
+    return total;
+}
+
+// Блок индекса ранга - ровно один регистр
+__attribute__((target("avx512f,avx512vpopcntdq,popcnt"))) inline void RankVpopcntdq(
+    const uint64_t* words, size_t count, uint64_t* rank) noexcept {
+    uint64_t total = 0;
+    size_t i = 0;
+    for (; i + kRankBlockWords <= count; i += kRankBlockWords) {
+        rank[i / kRankBlockWords] = total;
+        total += SumLanes(_mm512_popcnt_epi64(_mm512_loadu_si512(words + i)));
+    }
+    if (i < count) {
+        rank[i / kRankBlockWords] = total;
+        for (; i < count; ++i) {
+            total += PopCount(words[i]);
+        }
+    }
+    rank[(count + kRankBlockWords - 1) / kRankBlockWords] = total;
+}
+#endif
+
+inline size_t PopCountWords(const uint64_t* words, size_t count, simd::Isa isa) noexcept {
+#if VECTOR_SIMD_DISPATCH
+    if (isa == simd::Isa::kAvx512 && HasVectorPopCount()) {
+        return PopCountVpopcntdq(words, count);
+    }
+#endif
+    return simd::detail::Run<PopCountKernel>(isa, words, count);
+}
+
+inline void BuildRank(const uint64_t* words, size_t count, uint64_t* rank, simd::Isa isa) noexcept {
+#if VECTOR_SIMD_DISPATCH
+    if (isa == simd::Isa::kAvx512 && HasVectorPopCount()) {
+        RankVpopcntdq(words, count, rank);
+        return;
+    }
+#endif
+    simd::detail::Run<RankKernel>(isa, words, count, rank);
+}
+
+}  // namespace detail
+
+// Упакованный битовый вектор на 64-битных словах.
+// Биты за пределами Size() в последнем слове всегда нулевые. Подсчёт
+// единиц, построение индекса ранга и поразрядные операции выбирают
+// вариант набора инструкций, как ядра simd: POPCNT в AVX2 и AVX-512,
+// VPOPCNTDQ там, где он есть
+class BitVector {
+public:
+    static constexpr size_t kWordBits = 64;
+
+    class Reference {
+    public:
+        Reference(BitVector& bits, size_t index) noexcept
+            : bits_(&bits)
+            , index_(index) {
+        }
+
+        operator bool() const noexcept {
+            return bits_->Test(index_);
+        }
+
+        Reference& operator=(bool value) noexcept {
+            bits_->Set(index_, value);
+            return *this;
+        }
+
+        Reference& operator=(const Reference& other) noexcept {
+            return *this = static_cast<bool>(other);
+        }
+
+    private:
+        BitVector* bits_;
+        size_t index_;
+    };
+
+    BitVector() = default;
+
+    explicit BitVector(size_t size, bool value = false) {
+        Resize(size, value);
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    size_t Capacity() const noexcept {
+        return words_.Capacity() * kWordBits;
+    }
+
+    const uint64_t* Words() const noexcept {
+        return words_.begin();
+    }
+
+    size_t WordCount() const noexcept {
+        return words_.Size();
+    }
+
+    bool operator[](size_t index) const noexcept {
+        return Test(index);
+    }
+
+    Reference operator[](size_t index) noexcept {
+        return Reference(*this, index);
+    }
+
+    bool Test(size_t index) const noexcept {
+        assert(index < size_);
+        return (words_[index / kWordBits] >> (index % kWordBits)) & 1;
+    }
+
+    void Set(size_t index, bool value = true) noexcept {
+        assert(index < size_);
+        const uint64_t mask = uint64_t{1} << (index % kWordBits);
+        uint64_t& word = words_[index / kWordBits];
+        word = value ? (word | mask) : (word & ~mask);
+        rank_.Resize(0);
+    }
+
+    void Reserve(size_t bit_capacity) {
+        words_.Reserve(WordsFor(bit_capacity));
+    }
+
+    void Resize(size_t new_size, bool value = false) {
+        const size_t old_size = size_;
+        if (new_size > old_size && value && old_size % kWordBits != 0) {
+            words_[old_size / kWordBits] |= ~uint64_t{0} << (old_size % kWordBits);
+        }
+        const size_t old_words = words_.Size();
+        words_.Resize(WordsFor(new_size));
+        if (value) {
+            for (size_t i = old_words; i < words_.Size(); ++i) {
+                words_[i] = ~uint64_t{0};
+            }
+        }
+        size_ = new_size;
+        ClearTail();
+        rank_.Resize(0);
+    }
+
+    void PushBack(bool value) {
+        if (size_ % kWordBits == 0) {
+            words_.PushBack(0);
+        }
+        ++size_;
+        Set(size_ - 1, value);
+    }
+
+    void PopBack() noexcept {
+        assert(size_ > 0);
+        Set(size_ - 1, false);
+        --size_;
+        if (size_ % kWordBits == 0) {
+            words_.PopBack();
+        }
+    }
+
+    size_t Count(simd::Isa isa = simd::BestIsa()) const noexcept {
+        return detail::PopCountWords(words_.begin(), words_.Size(), isa);
+    }
+
+    // Позиция первого установленного бита, начиная с from, или Size()
+    size_t FindFirst(size_t from = 0) const noexcept {
+        if (from >= size_) {
+            return size_;
+        }
+        size_t word_index = from / kWordBits;
+        uint64_t word = words_[word_index] & (~uint64_t{0} << (from % kWordBits));
+        while (word == 0) {
+            if (++word_index == words_.Size()) {
+                return size_;
+            }
+            word = words_[word_index];
+        }
+        return word_index * kWordBits + detail::CountTrailingZeros(word);
+    }
+
+    BitVector& operator&=(const BitVector& rhs) noexcept {
+        return Combine(rhs, [](uint64_t a, uint64_t b) {
+            return a & b;
+        });
+    }
+
+    BitVector& operator|=(const BitVector& rhs) noexcept {
+        return Combine(rhs, [](uint64_t a, uint64_t b) {
+            return a | b;
+        });
+    }
+
+    BitVector& operator^=(const BitVector& rhs) noexcept {
+        return Combine(rhs, [](uint64_t a, uint64_t b) {
+            return a ^ b;
+        });
+    }
+
+    BitVector& AndNot(const BitVector& rhs) noexcept {
+        return Combine(rhs, [](uint64_t a, uint64_t b) {
+            return a & ~b;
+        });
+    }
+
+    // Индекс ранга: накопленное число единиц перед каждым блоком из 8 слов.
+    // Одно 64-битное число на 512 бит данных - 12,5% к их размеру.
+    // Сбрасывается при любом изменении
+    void BuildRankIndex(simd::Isa isa = simd::BestIsa()) {
+        Vector<uint64_t> rank((words_.Size() + kBlockWords - 1) / kBlockWords + 1);
+        detail::BuildRank(words_.begin(), words_.Size(), rank.begin(), isa);
+        rank_.Swap(rank);
+    }
+
+    bool HasRankIndex() const noexcept {
+        return rank_.Size() != 0;
+    }
+
+    // Число единиц в позициях [0, index), O(1)
+    size_t Rank(size_t index) const noexcept {
+        assert(HasRankIndex());
+        assert(index <= size_);
+        const size_t word_index = index / kWordBits;
+        const size_t block = word_index / kBlockWords;
+        size_t rank = rank_[block];
+        for (size_t i = block * kBlockWords; i < word_index; ++i) {
+            rank += detail::PopCount(words_[i]);
+        }
+        if (index % kWordBits != 0) {
+            rank += detail::PopCount(words_[word_index] & ((uint64_t{1} << (index % kWordBits)) - 1));
+        }
+        return rank;
+    }
+
+    // Позиция k-й (с нуля) единицы или Size(), если единиц меньше k + 1.
+    // Двоичный поиск по блокам и просмотр не более 8 слов
+    size_t Select(size_t k) const noexcept {
+        assert(HasRankIndex());
+        if (k >= rank_[rank_.Size() - 1]) {
+            return size_;
+        }
+        size_t lo = 0;
+        size_t hi = rank_.Size() - 1;
+        while (hi - lo > 1) {
+            const size_t mid = lo + (hi - lo) / 2;
+            if (rank_[mid] <= k) {
+                lo = mid;
+            } else {
+                hi = mid;
+            }
+        }
+        size_t remaining = k - rank_[lo];
+        for (size_t i = lo * kBlockWords;; ++i) {
+            const unsigned count = detail::PopCount(words_[i]);
+            if (remaining < count) {
+                return i * kWordBits + detail::SelectInWord(words_[i], static_cast<unsigned>(remaining));
+            }
+            remaining -= count;
+        }
+    }
+
+private:
+    static constexpr size_t kBlockWords = detail::kRankBlockWords;
+
+    static size_t WordsFor(size_t bits) noexcept {
+        return (bits + kWordBits - 1) / kWordBits;
+    }
+
+    void ClearTail() noexcept {
+        if (size_ % kWordBits != 0) {
+            words_[words_.Size() - 1] &= (uint64_t{1} << (size_ % kWordBits)) - 1;
+        }
+    }
+
+    template <typename Operation>
+    BitVector& Combine(const BitVector& rhs, Operation operation) noexcept {
+        assert(size_ == rhs.size_);
+        simd::detail::Run<detail::CombineKernel>(simd::BestIsa(), words_.begin(), rhs.words_.begin(), words_.Size(),
+                                                 operation);
+        rank_.Resize(0);
+        return *this;
+    }
+
+    Vector<uint64_t> words_;
+    Vector<uint64_t> rank_;
+    size_t size_ = 0;
+};
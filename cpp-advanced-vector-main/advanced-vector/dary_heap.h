@@ -0,0 +1,201 @@
+#pragma once
+
+#include "span.h"
+#include "vector.h"
+
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <utility>
+
+// Отслеживание позиций не требуется
+struct NoHeapPositions {
+    template <typename T>
+    void operator()(const T&, size_t) const noexcept {
+    }
+};
+
+// d-арная куча поверх Vector<T>. При D = 4 или 8 все потомки узла лежат
+// в одной-двух кеш-линиях, а высота дерева в log2(D) раз меньше двоичной.
+// Как и std::priority_queue, с std::less на вершине наибольший элемент.
+// OnMove(value, position) вызывается при каждом перемещении элемента и
+// позволяет вести внешний индекс позиций для Update/Erase
+template <typename T, size_t D = 4, typename Compare = std::less<T>, typename OnMove = NoHeapPositions>
+class DaryHeap {
+    static_assert(D >= 2, "Heap arity must be at least 2");
+
+public:
+    explicit DaryHeap(Compare compare = Compare(), OnMove on_move = OnMove())
+        : compare_(std::move(compare))
+        , on_move_(std::move(on_move)) {
+    }
+
+    size_t Size() const noexcept {
+        return data_.Size();
+    }
+
+    bool Empty() const noexcept {
+        return data_.Size() == 0;
+    }
+
+    void Reserve(size_t capacity) {
+        data_.Reserve(capacity);
+    }
+
+    const T& Top() const noexcept {
+        assert(!Empty());
+        return data_[0];
+    }
+
+    const T& At(size_t position) const noexcept {
+        return data_[position];
+    }
+
+    void Push(const T& value) {
+        data_.PushBack(value);
+        SiftUp(Size() - 1);
+    }
+
+    void Push(T&& value) {
+        data_.PushBack(std::move(value));
+        SiftUp(Size() - 1);
+    }
+
+    // Большая пачка добавляется целиком и упорядочивается за O(n)
+    void PushRange(Span<const T> values) {
+        const size_t old_size = Size();
+        if (old_size + values.Size() > data_.Capacity()) {
+            data_.Reserve(std::max(old_size + values.Size(), old_size * 2));
+        }
+        for (const T& value : values) {
+            data_.PushBack(value);
+        }
+        if (values.Size() > old_size) {
+            Heapify();
+        } else {
+            for (size_t i = old_size; i < Size(); ++i) {
+                SiftUp(i);
+            }
+        }
+    }
+
+    // Снятие снизу вверх, как в std::pop_heap: дыра спускается до листа
+    // по лучшим потомкам без сравнения с последним элементом, затем он
+    // поднимается от листа. Последний элемент обычно и принадлежит нижним
+    // уровням, поэтому сравнений и непредсказуемых переходов меньше
+    void Pop() {
+        assert(!Empty());
+        T value = std::move(data_[Size() - 1]);
+        data_.PopBack();
+        if (Empty()) {
+            return;
+        }
+        const size_t size = Size();
+        size_t position = 0;
+        for (size_t first_child = 1; first_child < size; first_child = position * D + 1) {
+            const size_t best = BestChild(first_child, std::min(first_child + D, size));
+            Place(position, std::move(data_[best]));
+            position = best;
+        }
+        SiftUpValue(position, std::move(value));
+    }
+
+    // Заменяет элемент в позиции position (например, уменьшение ключа)
+    void Replace(size_t position, T value) {
+        assert(position < Size());
+        data_[position] = std::move(value);
+        Update(position);
+    }
+
+    // Восстанавливает порядок после изменения элемента в позиции position
+    void Update(size_t position) {
+        if (position > 0 && compare_(data_[Parent(position)], data_[position])) {
+            SiftUp(position);
+        } else {
+            SiftDown(position);
+        }
+    }
+
+    void Erase(size_t position) {
+        assert(position < Size());
+        const size_t last = Size() - 1;
+        if (position != last) {
+            data_[position] = std::move(data_[last]);
+            data_.PopBack();
+            Update(position);
+        } else {
+            data_.PopBack();
+        }
+    }
+
+private:
+    static size_t Parent(size_t position) noexcept {
+        return (position - 1) / D;
+    }
+
+    void Place(size_t position, T&& value) {
+        data_[position] = std::move(value);
+        on_move_(data_[position], position);
+    }
+
+    // Потомок из [first, last), который должен стоять выше остальных
+    size_t BestChild(size_t first, size_t last) const {
+        size_t best = first;
+        for (size_t child = first + 1; child < last; ++child) {
+            if (compare_(data_[best], data_[child])) {
+                best = child;
+            }
+        }
+        return best;
+    }
+
+    void SiftUp(size_t position) {
+        SiftUpValue(position, std::move(data_[position]));
+    }
+
+    // Поднимает value, начиная с позиции-дыры position
+    void SiftUpValue(size_t position, T value) {
+        while (position > 0) {
+            const size_t parent = Parent(position);
+            if (!compare_(data_[parent], value)) {
+                break;
+            }
+            Place(position, std::move(data_[parent]));
+            position = parent;
+        }
+        Place(position, std::move(value));
+    }
+
+    void SiftDown(size_t position) {
+        const size_t size = Size();
+        T value = std::move(data_[position]);
+        while (true) {
+            const size_t first_child = position * D + 1;
+            if (first_child >= size) {
+                break;
+            }
+            const size_t best = BestChild(first_child, std::min(first_child + D, size));
+            if (!compare_(value, data_[best])) {
+                break;
+            }
+            Place(position, std::move(data_[best]));
+            position = best;
+        }
+        Place(position, std::move(value));
+    }
+
+    // Алгоритм Флойда: просеивание вниз от последнего внутреннего узла
+    void Heapify() {
+        for (size_t i = Size(); i-- > 0;) {
+            if (i * D + 1 >= Size()) {
+                on_move_(data_[i], i);
+            } else {
+                SiftDown(i);
+            }
+        }
+    }
+
+    Vector<T> data_;
+    Compare compare_;
+    OnMove on_move_;
+};
@@ -0,0 +1,217 @@
+#pragma once
+
+#include "flat_hash_map.h"
+#include "vector.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <variant>
+
+// Словарное кодирование: различные значения хранятся один раз в словаре,
+// а сами элементы - узкими кодами. Ширина кода (1, 2 или 4 байта)
+// увеличивается автоматически по мере роста числа различных значений.
+// Индекс значений - таблица кодов с открытой адресацией: хеш и сравнение
+// берут значение из словаря, поэтому каждое значение хранится один раз
+template <typename T, typename Hash = std::hash<T>>
+class DictVector {
+    using Codes = std::variant<Vector<uint8_t>, Vector<uint16_t>, Vector<uint32_t>>;
+
+public:
+    using Code = uint32_t;
+
+    DictVector() = default;
+
+    size_t Size() const noexcept {
+        return std::visit([](const auto& codes) {
+            return codes.Size();
+        }, codes_);
+    }
+
+    size_t Cardinality() const noexcept {
+        return dictionary_.Size();
+    }
+
+    size_t CodeWidth() const noexcept {
+        return std::visit([](const auto& codes) {
+            return sizeof(*codes.begin());
+        }, codes_);
+    }
+
+    const Vector<T>& Dictionary() const noexcept {
+        return dictionary_;
+    }
+
+    Code CodeAt(size_t index) const noexcept {
+        return std::visit([index](const auto& codes) {
+            return static_cast<Code>(codes[index]);
+        }, codes_);
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        return dictionary_[CodeAt(index)];
+    }
+
+    std::optional<Code> FindCode(const T& value) const {
+        if (index_.Size() == 0) {
+            return std::nullopt;
+        }
+        const Code code = index_[FindPosition(value)];
+        if (code == kNoCode) {
+            return std::nullopt;
+        }
+        return code;
+    }
+
+    void PushBack(const T& value) {
+        const Code code = Intern(value);
+        std::visit([code](auto& codes) {
+            using CodeType = std::remove_reference_t<decltype(*codes.begin())>;
+            codes.PushBack(static_cast<CodeType>(code));
+        }, codes_);
+    }
+
+    void PopBack() noexcept {
+        std::visit([](auto& codes) {
+            codes.PopBack();
+        }, codes_);
+    }
+
+    void Reserve(size_t capacity) {
+        std::visit([capacity](auto& codes) {
+            codes.Reserve(capacity);
+        }, codes_);
+    }
+
+    // Число элементов, равных value: сравниваются только коды
+    size_t Count(const T& value) const {
+        const auto code = FindCode(value);
+        if (!code) {
+            return 0;
+        }
+        return std::visit([code = *code](const auto& codes) {
+            size_t count = 0;
+            for (const auto element : codes) {
+                count += element == code;
+            }
+            return count;
+        }, codes_);
+    }
+
+    // Позиции элементов, равных value
+    Vector<size_t> FindAll(const T& value) const {
+        Vector<size_t> positions;
+        const auto code = FindCode(value);
+        if (!code) {
+            return positions;
+        }
+        std::visit([&positions, code = *code](const auto& codes) {
+            for (size_t i = 0; i < codes.Size(); ++i) {
+                if (codes[i] == code) {
+                    positions.PushBack(i);
+                }
+            }
+        }, codes_);
+        return positions;
+    }
+
+    // Гистограмма по кодам: элемент с индексом c - число вхождений Dictionary()[c]
+    Vector<size_t> CountByCode() const {
+        Vector<size_t> counts(dictionary_.Size());
+        std::visit([&counts](const auto& codes) {
+            for (const auto code : codes) {
+                ++counts[code];
+            }
+        }, codes_);
+        return counts;
+    }
+
+private:
+    // Пустая ячейка таблицы индекса
+    static constexpr Code kNoCode = std::numeric_limits<Code>::max();
+
+    // Ячейка с кодом value или пустая ячейка, где он должен оказаться.
+    // Таблица заполнена не более чем наполовину, поэтому поиск конечен
+    size_t FindPosition(const T& value) const {
+        const size_t mask = index_.Size() - 1;
+        for (size_t i = detail::MixHash(hash_(value)) & mask;; i = (i + 1) & mask) {
+            const Code code = index_[i];
+            if (code == kNoCode || dictionary_[code] == value) {
+                return i;
+            }
+        }
+    }
+
+    // Строит таблицу заново по словарю
+    void Rehash(size_t table_size) {
+        Vector<Code> index(table_size);
+        std::fill(index.begin(), index.end(), kNoCode);
+        const size_t mask = table_size - 1;
+        for (size_t code = 0; code < dictionary_.Size(); ++code) {
+            size_t i = detail::MixHash(hash_(dictionary_[code])) & mask;
+            while (index[i] != kNoCode) {
+                i = (i + 1) & mask;
+            }
+            index[i] = static_cast<Code>(code);
+        }
+        index_.Swap(index);
+    }
+
+    Code Intern(const T& value) {
+        if (index_.Size() != 0) {
+            if (const Code code = index_[FindPosition(value)]; code != kNoCode) {
+                return code;
+            }
+        }
+        const size_t code = dictionary_.Size();
+        if (code >= kNoCode) {
+            throw std::length_error("DictVector: too many distinct values");
+        }
+        if (code > MaxCode()) {
+            Widen();
+        }
+        if ((code + 1) * 2 > index_.Size()) {
+            Rehash(std::max<size_t>(index_.Size() * 2, 16));
+        }
+        // Позиция ищется до вставки: сравнение со значениями словаря
+        const size_t position = FindPosition(value);
+        dictionary_.PushBack(value);
+        index_[position] = static_cast<Code>(code);
+        return static_cast<Code>(code);
+    }
+
+    size_t MaxCode() const noexcept {
+        return std::visit([](const auto& codes) {
+            using CodeType = std::remove_const_t<std::remove_reference_t<decltype(*codes.begin())>>;
+            return static_cast<size_t>(std::numeric_limits<CodeType>::max());
+        }, codes_);
+    }
+
+    void Widen() {
+        if (std::holds_alternative<Vector<uint8_t>>(codes_)) {
+            codes_ = Convert<uint16_t>(std::get<Vector<uint8_t>>(codes_));
+        } else {
+            codes_ = Convert<uint32_t>(std::get<Vector<uint16_t>>(codes_));
+        }
+    }
+
+    template <typename To, typename From>
+    static Vector<To> Convert(const Vector<From>& from) {
+        Vector<To> to;
+        to.Reserve(from.Capacity());
+        for (const From code : from) {
+            to.PushBack(code);
+        }
+        return to;
+    }
+
+    Vector<T> dictionary_;
+    Vector<Code> index_;
+    Codes codes_;
+    Hash hash_;
+};
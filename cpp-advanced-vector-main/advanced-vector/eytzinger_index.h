@@ -0,0 +1,123 @@
+#pragma once
+
+#include "batch_lookup.h"
+#include "bit_vector.h"
+#include "span.h"
+#include "vector.h"
+
+#include <cassert>
+#include <cstdint>
+
+// Индекс для поиска в отсортированном массиве. Копия ключей хранится
+// в порядке обхода в ширину, поэтому первые уровни дерева делят несколько
+// строк кеша, а потомки узла лежат рядом.
+// При BlockSize == 1 это раскладка Эйтцингера: узел k (с единицы) имеет
+// потомков 2k и 2k + 1, спуск идёт без ветвлений с предвыборкой
+// на несколько уровней вперёд.
+// При BlockSize > 1 узел - блок из BlockSize ключей с BlockSize + 1
+// потомками (статическое B-дерево); блок удобно подбирать под строку кеша,
+// например 8 для uint64_t. Последний блок дополняется копиями максимума.
+// Результаты - позиции в исходном массиве
+template <typename T, size_t BlockSize = 1>
+class EytzingerIndex {
+    static_assert(BlockSize >= 1, "Block must hold at least one key");
+
+public:
+    EytzingerIndex() = default;
+
+    // sorted должен быть упорядочен по неубыванию; построение за O(n)
+    explicit EytzingerIndex(Span<const T> sorted)
+        : size_(sorted.Size()) {
+        if (size_ == 0) {
+            return;
+        }
+        if constexpr (BlockSize == 1) {
+            // Ячейка 0 не используется
+            keys_.Resize(size_ + 1);
+            positions_.Resize(size_ + 1);
+        } else {
+            const size_t slots = (size_ + BlockSize - 1) / BlockSize * BlockSize;
+            keys_.Resize(slots);
+            positions_.Resize(slots);
+        }
+        size_t next = 0;
+        Build(sorted, BlockSize == 1 ? 1 : 0, next);
+        assert(next == size_);
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    // Позиция первого элемента исходного массива, не меньшего key,
+    // или Size(), если такого нет
+    size_t LowerBound(const T& key) const {
+        if constexpr (BlockSize == 1) {
+            size_t k = 1;
+            while (k <= size_) {
+                if (k * kPrefetchStride <= size_) {
+                    detail::Prefetch(keys_.begin() + k * kPrefetchStride);
+                }
+                k = 2 * k + static_cast<size_t>(keys_[k] < key);
+            }
+            // Отбрасываем хвост шагов вправо и последний шаг влево
+            k >>= detail::CountTrailingZeros(~static_cast<uint64_t>(k)) + 1;
+            return k == 0 ? size_ : positions_[k];
+        } else {
+            const size_t blocks = keys_.Size() / BlockSize;
+            size_t result = size_;
+            for (size_t block = 0; block < blocks;) {
+                const T* first = keys_.begin() + block * BlockSize;
+                size_t less = 0;
+                for (size_t i = 0; i < BlockSize; ++i) {
+                    less += static_cast<size_t>(first[i] < key);
+                }
+                if (less < BlockSize) {
+                    result = positions_[block * BlockSize + less];
+                }
+                block = block * (BlockSize + 1) + less + 1;
+            }
+            return result;
+        }
+    }
+
+private:
+    // Потомки узла k на 4 уровня ниже занимают 16 соседних ячеек
+    static constexpr size_t kPrefetchStride = 16;
+
+    // Симметричный обход дерева раздаёт элементы по возрастанию
+    void Build(Span<const T> sorted, size_t node, size_t& next) {
+        if constexpr (BlockSize == 1) {
+            if (node > size_) {
+                return;
+            }
+            Build(sorted, 2 * node, next);
+            keys_[node] = sorted[next];
+            positions_[node] = next++;
+            Build(sorted, 2 * node + 1, next);
+        } else {
+            if (node >= keys_.Size() / BlockSize) {
+                return;
+            }
+            for (size_t i = 0; i <= BlockSize; ++i) {
+                Build(sorted, node * (BlockSize + 1) + i + 1, next);
+                if (i == BlockSize) {
+                    break;
+                }
+                const size_t slot = node * BlockSize + i;
+                if (next < size_) {
+                    keys_[slot] = sorted[next];
+                    positions_[slot] = next++;
+                } else {
+                    // Дополнение попадает в конец симметричного порядка
+                    keys_[slot] = sorted[size_ - 1];
+                    positions_[slot] = size_;
+                }
+            }
+        }
+    }
+
+    Vector<T> keys_;
+    Vector<size_t> positions_;
+    size_t size_ = 0;
+};
@@ -0,0 +1,496 @@
+#pragma once
+
+#include "batch_lookup.h"
+#include "bit_vector.h"
+#include "span.h"
+#include "vector.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace detail {
+
+// Управляющие байты в духе SwissTable: 0x80 - пусто, 0xFE - удалено,
+// 0x00..0x7F - занято, младшие 7 бит хеша
+constexpr uint8_t kCtrlEmpty = 0x80;
+constexpr uint8_t kCtrlDeleted = 0xFE;
+
+// Группа из 8 управляющих байтов, обрабатываемая одним 64-битным словом
+class CtrlGroup {
+public:
+    static constexpr size_t kWidth = 8;
+
+    explicit CtrlGroup(const uint8_t* ctrl) noexcept {
+        std::memcpy(&word_, ctrl, sizeof(word_));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        word_ = __builtin_bswap64(word_);
+#endif
+    }
+
+    // Маска старших битов байтов, равных h2 (возможны ложные срабатывания,
+    // поэтому вызывающий сверяет байт и ключ)
+    uint64_t Match(uint8_t h2) const noexcept {
+        const uint64_t x = word_ ^ (kLsbs * h2);
+        return (x - kLsbs) & ~x & kMsbs;
+    }
+
+    uint64_t MatchEmpty() const noexcept {
+        return word_ & ~(word_ << 6) & kMsbs;
+    }
+
+    uint64_t MatchEmptyOrDeleted() const noexcept {
+        return word_ & kMsbs;
+    }
+
+    // Номер байта по биту маски
+    static size_t Index(uint64_t mask) noexcept {
+        return CountTrailingZeros(mask) / 8;
+    }
+
+private:
+    static constexpr uint64_t kLsbs = 0x0101010101010101ULL;
+    static constexpr uint64_t kMsbs = 0x8080808080808080ULL;
+
+    uint64_t word_;
+};
+
+inline uint64_t MixHash(uint64_t hash) noexcept {
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+template <typename Hash, typename Eq, typename = void>
+constexpr bool kIsTransparent = false;
+
+template <typename Hash, typename Eq>
+constexpr bool kIsTransparent<Hash, Eq, std::void_t<typename Hash::is_transparent, typename Eq::is_transparent>> =
+    true;
+
+// Хеш-таблица с открытой адресацией: элементы лежат в одном массиве
+// RawMemory<Slot>, рядом - массив управляющих байтов. Пробирование идёт
+// группами по 8 слотов, загрузка не превышает 7/8
+template <typename Slot, typename GetKey, typename Hash, typename Eq>
+class FlatHashTable {
+public:
+    FlatHashTable() = default;
+
+    FlatHashTable(const FlatHashTable& other)
+        : hash_(other.hash_)
+        , eq_(other.eq_) {
+        Reserve(other.size_);
+        other.ForEach([this](const Slot& slot) {
+            InsertUnique(slot);
+        });
+    }
+
+    FlatHashTable(FlatHashTable&& other) noexcept {
+        Swap(other);
+    }
+
+    FlatHashTable& operator=(const FlatHashTable& rhs) {
+        if (this != &rhs) {
+            FlatHashTable rhs_copy(rhs);
+            Swap(rhs_copy);
+        }
+        return *this;
+    }
+
+    FlatHashTable& operator=(FlatHashTable&& rhs) noexcept {
+        if (this != &rhs) {
+            Swap(rhs);
+        }
+        return *this;
+    }
+
+    ~FlatHashTable() {
+        DestroySlots();
+    }
+
+    void Swap(FlatHashTable& other) noexcept {
+        slots_.Swap(other.slots_);
+        ctrl_.Swap(other.ctrl_);
+        std::swap(size_, other.size_);
+        std::swap(growth_left_, other.growth_left_);
+        std::swap(hash_, other.hash_);
+        std::swap(eq_, other.eq_);
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    bool Empty() const noexcept {
+        return size_ == 0;
+    }
+
+    size_t Capacity() const noexcept {
+        return slots_.Capacity();
+    }
+
+    void Reserve(size_t count) {
+        if (count > size_ + growth_left_) {
+            Rehash(CapacityFor(count));
+        }
+    }
+
+    void Clear() noexcept {
+        DestroySlots();
+        std::fill(ctrl_.begin(), ctrl_.end(), kCtrlEmpty);
+        size_ = 0;
+        growth_left_ = MaxLoad(Capacity());
+    }
+
+    template <typename Func>
+    void ForEach(Func func) const {
+        for (size_t i = 0; i < Capacity(); ++i) {
+            if (IsFull(ctrl_[i])) {
+                func(slots_[i]);
+            }
+        }
+    }
+
+    template <typename Func>
+    void ForEach(Func func) {
+        for (size_t i = 0; i < Capacity(); ++i) {
+            if (IsFull(ctrl_[i])) {
+                func(slots_[i]);
+            }
+        }
+    }
+
+protected:
+    static constexpr size_t kNotFound = SIZE_MAX;
+
+    template <typename Key>
+    size_t FindIndex(const Key& key) const {
+        if (Capacity() == 0) {
+            return kNotFound;
+        }
+        return FindIndexHashed(key, MixHash(hash_(key)));
+    }
+
+    // Сначала для всей группы ключей считаются хеши и запрашиваются
+    // первые группы управляющих байтов и слоты, затем выполняются проверки:
+    // промахи кеша разных ключей перекрываются. on_found(i, index)
+    // получает индекс слота или kNotFound
+    template <typename Key, typename Func>
+    void FindIndexBatch(Span<const Key> keys, Func on_found) const {
+        if (Capacity() == 0) {
+            for (size_t i = 0; i < keys.Size(); ++i) {
+                on_found(i, kNotFound);
+            }
+            return;
+        }
+        const size_t mask = Capacity() - 1;
+        uint64_t hashes[kBatchLanes];
+        for (size_t begin = 0; begin < keys.Size(); begin += kBatchLanes) {
+            const size_t count = std::min(kBatchLanes, keys.Size() - begin);
+            for (size_t i = 0; i < count; ++i) {
+                hashes[i] = MixHash(hash_(keys[begin + i]));
+                const size_t position = H1(hashes[i]) & mask;
+                Prefetch(ctrl_.begin() + position);
+                Prefetch(slots_ + position);
+            }
+            for (size_t i = 0; i < count; ++i) {
+                on_found(begin + i, FindIndexHashed(keys[begin + i], hashes[i]));
+            }
+        }
+    }
+
+    template <typename Key>
+    size_t FindIndexHashed(const Key& key, uint64_t hash) const {
+        const uint8_t h2 = H2(hash);
+        const size_t mask = Capacity() - 1;
+        size_t position = H1(hash) & mask;
+        for (size_t step = CtrlGroup::kWidth;; step += CtrlGroup::kWidth) {
+            const CtrlGroup group(ctrl_.begin() + position);
+            for (uint64_t match = group.Match(h2); match != 0; match &= match - 1) {
+                const size_t index = (position + CtrlGroup::Index(match)) & mask;
+                if (ctrl_[index] == h2 && eq_(GetKey{}(slots_[index]), key)) {
+                    return index;
+                }
+            }
+            if (group.MatchEmpty() != 0) {
+                return kNotFound;
+            }
+            position = (position + step) & mask;
+        }
+    }
+
+    // Возвращает индекс и признак вставки; при наличии ключа ничего не создаётся
+    template <typename Key, typename... Args>
+    std::pair<size_t, bool> TryEmplace(const Key& key, Args&&... args) {
+        if (const size_t index = FindIndex(key); index != kNotFound) {
+            return {index, false};
+        }
+        return {InsertNew(MixHash(hash_(key)), std::forward<Args>(args)...), true};
+    }
+
+    template <typename Key>
+    bool EraseKey(const Key& key) {
+        const size_t index = FindIndex(key);
+        if (index == kNotFound) {
+            return false;
+        }
+        std::destroy_at(slots_ + index);
+        SetCtrl(index, kCtrlDeleted);
+        --size_;
+        return true;
+    }
+
+    Slot& SlotAt(size_t index) noexcept {
+        return slots_[index];
+    }
+
+    const Slot& SlotAt(size_t index) const noexcept {
+        return slots_[index];
+    }
+
+private:
+    static uint8_t H2(uint64_t hash) noexcept {
+        return static_cast<uint8_t>(hash & 0x7f);
+    }
+
+    static size_t H1(uint64_t hash) noexcept {
+        return static_cast<size_t>(hash >> 7);
+    }
+
+    static bool IsFull(uint8_t ctrl) noexcept {
+        return (ctrl & 0x80) == 0;
+    }
+
+    static size_t MaxLoad(size_t capacity) noexcept {
+        return capacity - capacity / 8;
+    }
+
+    static size_t CapacityFor(size_t count) noexcept {
+        size_t capacity = CtrlGroup::kWidth;
+        while (MaxLoad(capacity) < count) {
+            capacity *= 2;
+        }
+        return capacity;
+    }
+
+    // Первые kWidth байтов продублированы в хвосте массива, чтобы группа,
+    // начинающаяся у конца таблицы, читалась одним словом
+    void SetCtrl(size_t index, uint8_t value) noexcept {
+        ctrl_[index] = value;
+        if (index < CtrlGroup::kWidth) {
+            ctrl_[Capacity() + index] = value;
+        }
+    }
+
+    size_t FindInsertPosition(uint64_t hash) const noexcept {
+        const size_t mask = Capacity() - 1;
+        size_t position = H1(hash) & mask;
+        for (size_t step = CtrlGroup::kWidth;; step += CtrlGroup::kWidth) {
+            const CtrlGroup group(ctrl_.begin() + position);
+            if (const uint64_t free = group.MatchEmptyOrDeleted(); free != 0) {
+                return (position + CtrlGroup::Index(free)) & mask;
+            }
+            position = (position + step) & mask;
+        }
+    }
+
+    template <typename... Args>
+    size_t InsertNew(uint64_t hash, Args&&... args) {
+        size_t index = Capacity() == 0 ? 0 : FindInsertPosition(hash);
+        if (Capacity() == 0 || (growth_left_ == 0 && ctrl_[index] == kCtrlEmpty)) {
+            // Много удалённых слотов - перестраиваем на месте, иначе растём
+            size_t new_capacity = CtrlGroup::kWidth;
+            if (Capacity() != 0) {
+                new_capacity = size_ * 2 <= MaxLoad(Capacity()) ? Capacity() : Capacity() * 2;
+            }
+            // Элемент создаётся до перестройки: аргументы могут ссылаться на таблицу
+            alignas(Slot) unsigned char buffer[sizeof(Slot)];
+            Slot* pending = new (buffer) Slot(std::forward<Args>(args)...);
+            try {
+                Rehash(new_capacity);
+                index = FindInsertPosition(hash);
+                new (slots_ + index) Slot(std::move_if_noexcept(*pending));
+            } catch (...) {
+                std::destroy_at(pending);
+                throw;
+            }
+            std::destroy_at(pending);
+        } else {
+            new (slots_ + index) Slot(std::forward<Args>(args)...);
+        }
+        if (ctrl_[index] == kCtrlEmpty) {
+            --growth_left_;
+        }
+        SetCtrl(index, H2(hash));
+        ++size_;
+        return index;
+    }
+
+    void InsertUnique(const Slot& slot) {
+        InsertNew(MixHash(hash_(GetKey{}(slot))), slot);
+    }
+
+    // Переносит элементы в новый массив. Тривиально копируемые слоты
+    // перемещаются memcpy, остальные - как в Vector: перемещением, если
+    // оно не бросает исключений, иначе копированием
+    void Rehash(size_t new_capacity) {
+        assert((new_capacity & (new_capacity - 1)) == 0 && new_capacity >= CtrlGroup::kWidth);
+        RawMemory<Slot> new_slots(new_capacity);
+        Vector<uint8_t> new_ctrl(new_capacity + CtrlGroup::kWidth);
+        std::fill(new_ctrl.begin(), new_ctrl.end(), kCtrlEmpty);
+
+        FlatHashTable fresh;
+        fresh.slots_.Swap(new_slots);
+        fresh.ctrl_.Swap(new_ctrl);
+        fresh.growth_left_ = MaxLoad(new_capacity);
+        fresh.hash_ = hash_;
+        fresh.eq_ = eq_;
+
+        for (size_t i = 0; i < Capacity(); ++i) {
+            if (!IsFull(ctrl_[i])) {
+                continue;
+            }
+            const uint64_t hash = MixHash(hash_(GetKey{}(slots_[i])));
+            const size_t index = fresh.FindInsertPosition(hash);
+            if constexpr (std::is_trivially_copyable_v<Slot>) {
+                std::memcpy(static_cast<void*>(fresh.slots_ + index), slots_ + i, sizeof(Slot));
+            } else {
+                new (fresh.slots_ + index) Slot(std::move_if_noexcept(slots_[i]));
+            }
+            fresh.SetCtrl(index, H2(hash));
+            ++fresh.size_;
+            --fresh.growth_left_;
+        }
+        Swap(fresh);
+    }
+
+    void DestroySlots() noexcept {
+        if constexpr (!std::is_trivially_destructible_v<Slot>) {
+            for (size_t i = 0; i < Capacity(); ++i) {
+                if (IsFull(ctrl_[i])) {
+                    std::destroy_at(slots_ + i);
+                }
+            }
+        }
+    }
+
+    RawMemory<Slot> slots_;
+    Vector<uint8_t> ctrl_;
+    size_t size_ = 0;
+    size_t growth_left_ = 0;
+    Hash hash_;
+    Eq eq_;
+};
+
+struct GetMapKey {
+    template <typename Slot>
+    const auto& operator()(const Slot& slot) const noexcept {
+        return slot.first;
+    }
+};
+
+struct GetSetKey {
+    template <typename Slot>
+    const Slot& operator()(const Slot& slot) const noexcept {
+        return slot;
+    }
+};
+
+}  // namespace detail
+
+// Хеш-словарь с открытой адресацией. Поиск по ключу другого типа
+// доступен, если Hash и Eq объявляют is_transparent
+template <typename K, typename V, typename Hash = std::hash<K>, typename Eq = std::equal_to<K>>
+class FlatHashMap : public detail::FlatHashTable<std::pair<K, V>, detail::GetMapKey, Hash, Eq> {
+    using Base = detail::FlatHashTable<std::pair<K, V>, detail::GetMapKey, Hash, Eq>;
+
+    template <typename Q>
+    using EnableLookup =
+        std::enable_if_t<std::is_same_v<Q, K> || detail::kIsTransparent<Hash, Eq>, int>;
+
+public:
+    using Base::Base;
+
+    // Возвращает false, если ключ уже есть; значение тогда не меняется
+    bool Insert(const K& key, V value) {
+        return this->TryEmplace(key, key, std::move(value)).second;
+    }
+
+    V& operator[](const K& key) {
+        return this->SlotAt(this->TryEmplace(key, key, V{}).first).second;
+    }
+
+    template <typename Q, EnableLookup<Q> = 0>
+    V* Find(const Q& key) {
+        const size_t index = this->FindIndex(key);
+        return index == Base::kNotFound ? nullptr : &this->SlotAt(index).second;
+    }
+
+    template <typename Q, EnableLookup<Q> = 0>
+    const V* Find(const Q& key) const {
+        const size_t index = this->FindIndex(key);
+        return index == Base::kNotFound ? nullptr : &this->SlotAt(index).second;
+    }
+
+    template <typename Q, EnableLookup<Q> = 0>
+    bool Contains(const Q& key) const {
+        return this->FindIndex(key) != Base::kNotFound;
+    }
+
+    // Пакетный поиск: out[i] - значение ключа keys[i] или nullptr
+    template <typename Q, EnableLookup<Q> = 0>
+    void FindBatch(Span<const Q> keys, Span<V*> out) {
+        assert(keys.Size() == out.Size());
+        this->FindIndexBatch(keys, [this, out](size_t i, size_t index) {
+            out[i] = index == Base::kNotFound ? nullptr : &this->SlotAt(index).second;
+        });
+    }
+
+    template <typename Q, EnableLookup<Q> = 0>
+    bool Erase(const Q& key) {
+        return this->EraseKey(key);
+    }
+};
+
+template <typename K, typename Hash = std::hash<K>, typename Eq = std::equal_to<K>>
+class FlatHashSet : public detail::FlatHashTable<K, detail::GetSetKey, Hash, Eq> {
+    using Base = detail::FlatHashTable<K, detail::GetSetKey, Hash, Eq>;
+
+    template <typename Q>
+    using EnableLookup =
+        std::enable_if_t<std::is_same_v<Q, K> || detail::kIsTransparent<Hash, Eq>, int>;
+
+public:
+    using Base::Base;
+
+    bool Insert(const K& key) {
+        return this->TryEmplace(key, key).second;
+    }
+
+    template <typename Q, EnableLookup<Q> = 0>
+    bool Contains(const Q& key) const {
+        return this->FindIndex(key) != Base::kNotFound;
+    }
+
+    template <typename Q, EnableLookup<Q> = 0>
+    void ContainsBatch(Span<const Q> keys, Span<bool> out) const {
+        assert(keys.Size() == out.Size());
+        this->FindIndexBatch(keys, [out](size_t i, size_t index) {
+            out[i] = index != Base::kNotFound;
+        });
+    }
+
+    template <typename Q, EnableLookup<Q> = 0>
+    bool Erase(const Q& key) {
+        return this->EraseKey(key);
+    }
+};
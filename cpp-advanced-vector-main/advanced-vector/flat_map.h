@@ -0,0 +1,252 @@
+#pragma once
+
+#include "span.h"
+#include "vector.h"
+
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+// Отсортированный ассоциативный массив: ключи и значения лежат в двух
+// параллельных Vector. Поиск - двоичный, пачка вставляется одним слиянием
+template <typename K, typename V, typename Compare = std::less<K>>
+class FlatMap {
+public:
+    using Entry = std::pair<K, V>;
+
+    explicit FlatMap(Compare compare = Compare())
+        : compare_(std::move(compare)) {
+    }
+
+    // Массовое построение из неупорядоченных пар: одна сортировка вместо
+    // n вставок. При повторе ключа остаётся первая пара
+    static FlatMap FromUnsorted(Vector<Entry> entries, Compare compare = Compare()) {
+        FlatMap result(std::move(compare));
+        result.InsertBatch(std::move(entries));
+        return result;
+    }
+
+    size_t Size() const noexcept {
+        return keys_.Size();
+    }
+
+    bool Empty() const noexcept {
+        return keys_.Size() == 0;
+    }
+
+    Span<const K> Keys() const noexcept {
+        return keys_;
+    }
+
+    Span<V> Values() noexcept {
+        return values_;
+    }
+
+    Span<const V> Values() const noexcept {
+        return values_;
+    }
+
+    void Reserve(size_t capacity) {
+        keys_.Reserve(capacity);
+        values_.Reserve(capacity);
+    }
+
+    size_t LowerBound(const K& key) const noexcept {
+        return std::lower_bound(keys_.begin(), keys_.end(), key, compare_) - keys_.begin();
+    }
+
+    V* Find(const K& key) noexcept {
+        const size_t position = LowerBound(key);
+        return IsMatch(position, key) ? &values_[position] : nullptr;
+    }
+
+    const V* Find(const K& key) const noexcept {
+        return const_cast<FlatMap&>(*this).Find(key);
+    }
+
+    bool Contains(const K& key) const noexcept {
+        return Find(key) != nullptr;
+    }
+
+    // Возвращает false, если ключ уже есть; значение тогда не меняется
+    bool Insert(const K& key, V value) {
+        const size_t position = LowerBound(key);
+        if (IsMatch(position, key)) {
+            return false;
+        }
+        keys_.Insert(keys_.begin() + position, key);
+        try {
+            values_.Insert(values_.begin() + position, std::move(value));
+        } catch (...) {
+            keys_.Erase(keys_.begin() + position);
+            throw;
+        }
+        return true;
+    }
+
+    V& operator[](const K& key) {
+        const size_t position = LowerBound(key);
+        if (!IsMatch(position, key)) {
+            Insert(key, V{});
+        }
+        return values_[position];
+    }
+
+    bool Erase(const K& key) {
+        const size_t position = LowerBound(key);
+        if (!IsMatch(position, key)) {
+            return false;
+        }
+        keys_.Erase(keys_.begin() + position);
+        values_.Erase(values_.begin() + position);
+        return true;
+    }
+
+    // Сортирует пачку и сливает её с содержимым за один проход,
+    // O(n + k log k). Существующие ключи не перезаписываются,
+    // из повторов внутри пачки остаётся первый. Свои элементы
+    // переносятся, только если перенос и ключа, и значения не бросает,
+    // иначе копируются: при исключении карта остаётся прежней
+    void InsertBatch(Vector<Entry> entries) {
+        std::stable_sort(entries.begin(), entries.end(), [this](const Entry& lhs, const Entry& rhs) {
+            return compare_(lhs.first, rhs.first);
+        });
+
+        Vector<K> keys;
+        Vector<V> values;
+        keys.Reserve(Size() + entries.Size());
+        values.Reserve(Size() + entries.Size());
+        size_t i = 0;
+        size_t j = 0;
+        while (i < Size() || j < entries.Size()) {
+            if (j == entries.Size() || (i < Size() && !compare_(entries[j].first, keys_[i]))) {
+                // Одинаковый ключ из пачки пропускается
+                if (j < entries.Size() && !compare_(keys_[i], entries[j].first)) {
+                    ++j;
+                    continue;
+                }
+                if constexpr (kNothrowMove) {
+                    keys.PushBack(std::move(keys_[i]));
+                    values.PushBack(std::move(values_[i]));
+                } else {
+                    keys.PushBack(keys_[i]);
+                    values.PushBack(values_[i]);
+                }
+                ++i;
+            } else {
+                if (keys.Size() == 0 || compare_(keys[keys.Size() - 1], entries[j].first)) {
+                    keys.PushBack(std::move(entries[j].first));
+                    values.PushBack(std::move(entries[j].second));
+                }
+                ++j;
+            }
+        }
+        keys_.Swap(keys);
+        values_.Swap(values);
+    }
+
+private:
+    static constexpr bool kNothrowMove =
+        std::is_nothrow_move_constructible_v<K> && std::is_nothrow_move_constructible_v<V>;
+
+    bool IsMatch(size_t position, const K& key) const noexcept {
+        return position != Size() && !compare_(key, keys_[position]);
+    }
+
+    Vector<K> keys_;
+    Vector<V> values_;
+    Compare compare_;
+};
+
+// Отсортированное множество в одном Vector
+template <typename K, typename Compare = std::less<K>>
+class FlatSet {
+public:
+    explicit FlatSet(Compare compare = Compare())
+        : compare_(std::move(compare)) {
+    }
+
+    static FlatSet FromUnsorted(Vector<K> keys, Compare compare = Compare()) {
+        FlatSet result(std::move(compare));
+        result.InsertBatch(std::move(keys));
+        return result;
+    }
+
+    size_t Size() const noexcept {
+        return keys_.Size();
+    }
+
+    bool Empty() const noexcept {
+        return keys_.Size() == 0;
+    }
+
+    Span<const K> Keys() const noexcept {
+        return keys_;
+    }
+
+    void Reserve(size_t capacity) {
+        keys_.Reserve(capacity);
+    }
+
+    size_t LowerBound(const K& key) const noexcept {
+        return std::lower_bound(keys_.begin(), keys_.end(), key, compare_) - keys_.begin();
+    }
+
+    bool Contains(const K& key) const noexcept {
+        return IsMatch(LowerBound(key), key);
+    }
+
+    bool Insert(const K& key) {
+        const size_t position = LowerBound(key);
+        if (IsMatch(position, key)) {
+            return false;
+        }
+        keys_.Insert(keys_.begin() + position, key);
+        return true;
+    }
+
+    bool Erase(const K& key) {
+        const size_t position = LowerBound(key);
+        if (!IsMatch(position, key)) {
+            return false;
+        }
+        keys_.Erase(keys_.begin() + position);
+        return true;
+    }
+
+    // Как FlatMap::InsertBatch: при исключении множество не меняется
+    void InsertBatch(Vector<K> keys) {
+        std::sort(keys.begin(), keys.end(), compare_);
+
+        Vector<K> merged;
+        merged.Reserve(Size() + keys.Size());
+        size_t i = 0;
+        size_t j = 0;
+        while (i < Size() || j < keys.Size()) {
+            const bool take_own = j == keys.Size() || (i < Size() && !compare_(keys[j], keys_[i]));
+            if (take_own) {
+                if constexpr (std::is_nothrow_move_constructible_v<K>) {
+                    merged.PushBack(std::move(keys_[i++]));
+                } else {
+                    merged.PushBack(keys_[i++]);
+                }
+            } else {
+                merged.PushBack(std::move(keys[j++]));
+            }
+            // Пропускаем повторы только что добавленного ключа в пачке
+            while (j < keys.Size() && !compare_(merged[merged.Size() - 1], keys[j])) {
+                ++j;
+            }
+        }
+        keys_.Swap(merged);
+    }
+
+private:
+    bool IsMatch(size_t position, const K& key) const noexcept {
+        return position != Size() && !compare_(key, keys_[position]);
+    }
+
+    Vector<K> keys_;
+    Compare compare_;
+};
@@ -0,0 +1,420 @@
+#pragma once
+
+#include "span.h"
+#include "vector.h"
+#include "vector_simd.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#if VECTOR_SIMD_DISPATCH
+#include <immintrin.h>
+#endif
+
+enum class HalfFormat {
+    FP16,
+    BF16,
+};
+
+namespace detail {
+
+inline uint32_t FloatBits(float value) noexcept {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+inline float BitsToFloat(uint32_t bits) noexcept {
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// IEEE 754 binary16, округление к ближайшему чётному. NaN сохраняет
+// знак и старшие биты мантиссы и становится тихим, как в VCVTPS2PH
+inline uint16_t FloatToFp16(float value) noexcept {
+    constexpr uint32_t kFloatInfinity = 255u << 23;
+    constexpr uint32_t kHalfOverflow = (127u + 16) << 23;
+    constexpr uint32_t kMinNormal = 113u << 23;
+    constexpr uint32_t kDenormMagic = ((127u - 15) + (23 - 10) + 1) << 23;
+
+    uint32_t bits = FloatBits(value);
+    const uint32_t sign = bits & 0x80000000u;
+    bits ^= sign;
+    uint32_t result;
+    if (bits >= kHalfOverflow) {
+        result = bits > kFloatInfinity ? 0x7e00 | ((bits >> 13) & 0x3ff) : 0x7c00;
+    } else if (bits < kMinNormal) {
+        const float shifted = BitsToFloat(bits) + BitsToFloat(kDenormMagic);
+        result = FloatBits(shifted) - kDenormMagic;
+    } else {
+        const uint32_t mantissa_odd = (bits >> 13) & 1;
+        bits += ((15u - 127) << 23) + 0xfff + mantissa_odd;
+        result = bits >> 13;
+    }
+    return static_cast<uint16_t>(result | (sign >> 16));
+}
+
+// NaN становится тихим, как в VCVTPH2PS
+inline float Fp16ToFloat(uint16_t half) noexcept {
+    constexpr uint32_t kShiftedExponent = 0x7c00u << 13;
+    constexpr uint32_t kMagic = 113u << 23;
+
+    uint32_t bits = (half & 0x7fffu) << 13;
+    const uint32_t exponent = bits & kShiftedExponent;
+    bits += (127u - 15) << 23;
+    if (exponent == kShiftedExponent) {
+        bits += (128u - 16) << 23;
+        if ((half & 0x3ffu) != 0) {
+            bits |= 1u << 22;
+        }
+    } else if (exponent == 0) {
+        bits += 1u << 23;
+        bits = FloatBits(BitsToFloat(bits) - BitsToFloat(kMagic));
+    }
+    return BitsToFloat(bits | ((half & 0x8000u) << 16));
+}
+
+// bfloat16: старшие 16 бит float, округление к ближайшему чётному
+inline uint16_t FloatToBf16(float value) noexcept {
+    const uint32_t bits = FloatBits(value);
+    if ((bits & 0x7fffffffu) > 0x7f800000u) {
+        return static_cast<uint16_t>((bits >> 16) | 0x40);
+    }
+    return static_cast<uint16_t>((bits + 0x7fff + ((bits >> 16) & 1)) >> 16);
+}
+
+inline float Bf16ToFloat(uint16_t half) noexcept {
+    return BitsToFloat(static_cast<uint32_t>(half) << 16);
+}
+
+// Независимых сумм в скалярном произведении и расстоянии: регистр AVX-512.
+// Значение с номером i всегда попадает в сумму i % kHalfLanes, поэтому
+// порядок сложения не зависит от варианта набора инструкций
+constexpr size_t kHalfLanes = 16;
+
+struct HalfDotKernel {
+    VECTOR_SIMD_INLINE static void Run(const float* lhs, const float* rhs, size_t count, float* sums) noexcept {
+        // Локальная копия: запись в sums могла бы менять входные данные
+        float lanes[kHalfLanes];
+        std::copy(sums, sums + kHalfLanes, lanes);
+        size_t i = 0;
+        for (; i + kHalfLanes <= count; i += kHalfLanes) {
+            for (size_t j = 0; j < kHalfLanes; ++j) {
+                lanes[j] += lhs[i + j] * rhs[i + j];
+            }
+        }
+        for (; i < count; ++i) {
+            lanes[i % kHalfLanes] += lhs[i] * rhs[i];
+        }
+        std::copy(lanes, lanes + kHalfLanes, sums);
+    }
+};
+
+struct HalfL2Kernel {
+    VECTOR_SIMD_INLINE static void Run(const float* lhs, const float* rhs, size_t count, float* sums) noexcept {
+        float lanes[kHalfLanes];
+        std::copy(sums, sums + kHalfLanes, lanes);
+        size_t i = 0;
+        for (; i + kHalfLanes <= count; i += kHalfLanes) {
+            for (size_t j = 0; j < kHalfLanes; ++j) {
+                const float diff = lhs[i + j] - rhs[i + j];
+                lanes[j] += diff * diff;
+            }
+        }
+        for (; i < count; ++i) {
+            const float diff = lhs[i] - rhs[i];
+            lanes[i % kHalfLanes] += diff * diff;
+        }
+        std::copy(lanes, lanes + kHalfLanes, sums);
+    }
+};
+
+struct Bf16DecodeKernel {
+    VECTOR_SIMD_INLINE static void Run(const uint16_t* in, float* out, size_t count) noexcept {
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = Bf16ToFloat(in[i]);
+        }
+    }
+};
+
+struct Bf16EncodeKernel {
+    VECTOR_SIMD_INLINE static void Run(const float* in, uint16_t* out, size_t count) noexcept {
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = FloatToBf16(in[i]);
+        }
+    }
+};
+
+inline float SumHalfLanes(const float* sums) noexcept {
+    float sum = 0;
+    for (size_t j = 0; j < kHalfLanes; ++j) {
+        sum += sums[j];
+    }
+    return sum;
+}
+
+#if VECTOR_SIMD_DISPATCH
+// Преобразования FP16 инструкциями F16C по 8 значений; хвост проходит
+// через дополненный нулями буфер, поэтому результат не зависит от длины
+__attribute__((target("avx2,f16c,fma"))) inline void Fp16ToFloatF16c(const uint16_t* in, float* out,
+                                                                      size_t count) noexcept {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m128i halves = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        _mm256_storeu_ps(out + i, _mm256_cvtph_ps(halves));
+    }
+    if (i < count) {
+        uint16_t halves[8] = {};
+        float floats[8];
+        std::memcpy(halves, in + i, (count - i) * sizeof(uint16_t));
+        _mm256_storeu_ps(floats, _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(halves))));
+        std::memcpy(out + i, floats, (count - i) * sizeof(float));
+    }
+}
+
+__attribute__((target("avx2,f16c,fma"))) inline void FloatToFp16F16c(const float* in, uint16_t* out,
+                                                                      size_t count) noexcept {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m128i halves = _mm256_cvtps_ph(_mm256_loadu_ps(in + i), _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), halves);
+    }
+    if (i < count) {
+        float floats[8] = {};
+        uint16_t halves[8];
+        std::memcpy(floats, in + i, (count - i) * sizeof(float));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(halves),
+                         _mm256_cvtps_ph(_mm256_loadu_ps(floats), _MM_FROUND_TO_NEAREST_INT));
+        std::memcpy(out + i, halves, (count - i) * sizeof(uint16_t));
+    }
+}
+
+// Те же преобразования по 16 значений
+VECTOR_SIMD_AVX512_BEGIN
+__attribute__((target("avx512f"))) inline void Fp16ToFloatAvx512(const uint16_t* in, float* out,
+                                                                 size_t count) noexcept {
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        const __m256i halves = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+        _mm512_storeu_ps(out + i, _mm512_cvtph_ps(halves));
+    }
+    Fp16ToFloatF16c(in + i, out + i, count - i);
+}
+
+__attribute__((target("avx512f"))) inline void FloatToFp16Avx512(const float* in, uint16_t* out,
+                                                                 size_t count) noexcept {
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        const __m256i halves = _mm512_cvtps_ph(_mm512_loadu_ps(in + i), _MM_FROUND_TO_NEAREST_INT);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), halves);
+    }
+    FloatToFp16F16c(in + i, out + i, count - i);
+}
+
+// AVX512_BF16 есть не у всех процессоров с AVX-512
+inline bool HasAvx512Bf16() noexcept {
+    static const bool has = simd::Supports(simd::Isa::kAvx512) && __builtin_cpu_supports("avx512bf16");
+    return has;
+}
+
+// VDPBF16PS умножает пары bfloat16 и складывает произведения во float
+// без промежуточного округления; субнормальные входы считаются нулём.
+// Возвращает число обработанных значений, хвост остаётся вызывающему
+__attribute__((target("avx512f,avx512bf16"))) inline size_t DotBf16Avx512(const uint16_t* lhs, const uint16_t* rhs,
+                                                                          size_t count, float* sums) noexcept {
+    __m512 acc = _mm512_loadu_ps(sums);
+    size_t i = 0;
+    for (; i + 32 <= count; i += 32) {
+        const __m512i left = _mm512_loadu_si512(lhs + i);
+        const __m512i right = _mm512_loadu_si512(rhs + i);
+        acc = _mm512_dpbf16_ps(acc, reinterpret_cast<const __m512bh&>(left),
+                               reinterpret_cast<const __m512bh&>(right));
+    }
+    _mm512_storeu_ps(sums, acc);
+    return i;
+}
+VECTOR_SIMD_AVX512_END
+#endif
+
+}  // namespace detail
+
+// Вектор чисел с плавающей точкой, хранящихся в 16 битах (FP16 или bfloat16).
+// Арифметика выполняется во float, преобразование идёт пакетами; для FP16
+// пакет преобразуется инструкциями F16C или AVX-512, если процессор их
+// поддерживает. Скалярные произведения и расстояния копят kHalfLanes
+// независимых сумм. Пакетные операции принимают вариант набора
+// инструкций, как ядра simd; преобразования дают одинаковые биты
+// при любом варианте
+template <HalfFormat Format>
+class HalfVector {
+public:
+    HalfVector() = default;
+
+    explicit HalfVector(Span<const float> values) {
+        EncodeFrom(values);
+    }
+
+    static uint16_t Encode(float value) noexcept {
+        if constexpr (Format == HalfFormat::FP16) {
+            return detail::FloatToFp16(value);
+        } else {
+            return detail::FloatToBf16(value);
+        }
+    }
+
+    static float Decode(uint16_t half) noexcept {
+        if constexpr (Format == HalfFormat::FP16) {
+            return detail::Fp16ToFloat(half);
+        } else {
+            return detail::Bf16ToFloat(half);
+        }
+    }
+
+    size_t Size() const noexcept {
+        return data_.Size();
+    }
+
+    const uint16_t* Data() const noexcept {
+        return data_.begin();
+    }
+
+    float operator[](size_t index) const noexcept {
+        return Decode(data_[index]);
+    }
+
+    void Set(size_t index, float value) noexcept {
+        data_[index] = Encode(value);
+    }
+
+    void Reserve(size_t capacity) {
+        data_.Reserve(capacity);
+    }
+
+    void PushBack(float value) {
+        data_.PushBack(Encode(value));
+    }
+
+    void PopBack() noexcept {
+        data_.PopBack();
+    }
+
+    // Заменяет содержимое значениями values
+    void EncodeFrom(Span<const float> values, simd::Isa isa = simd::BestIsa()) {
+        data_.Resize(values.Size());
+        EncodeBlock(values.Data(), data_.begin(), values.Size(), isa);
+    }
+
+    // Записывает Size() значений в out
+    void DecodeTo(Span<float> out, simd::Isa isa = simd::BestIsa()) const noexcept {
+        assert(out.Size() >= Size());
+        DecodeBlock(data_.begin(), out.Data(), Size(), isa);
+    }
+
+    float Dot(Span<const float> other, simd::Isa isa = simd::BestIsa()) const noexcept {
+        assert(other.Size() == Size());
+        float sums[detail::kHalfLanes] = {};
+        ForEachBlock(isa, [&sums, &other, isa](size_t offset, const float* block, size_t count) {
+            simd::detail::Run<detail::HalfDotKernel>(isa, block, other.Data() + offset, count, sums);
+        });
+        return detail::SumHalfLanes(sums);
+    }
+
+    // Оба операнда распаковываются блоками. Два Bf16Vector на процессоре
+    // с AVX512_BF16 перемножаются без распаковки
+    float Dot(const HalfVector& other, simd::Isa isa = simd::BestIsa()) const noexcept {
+        assert(other.Size() == Size());
+        float sums[detail::kHalfLanes] = {};
+        size_t done = 0;
+#if VECTOR_SIMD_DISPATCH
+        if (Format == HalfFormat::BF16 && isa == simd::Isa::kAvx512 && detail::HasAvx512Bf16()) {
+            done = detail::DotBf16Avx512(data_.begin(), other.data_.begin(), Size(), sums);
+        }
+#endif
+        float block[kBlockSize];
+        float other_block[kBlockSize];
+        for (size_t offset = done; offset < Size(); offset += kBlockSize) {
+            const size_t count = std::min(kBlockSize, Size() - offset);
+            DecodeBlock(data_.begin() + offset, block, count, isa);
+            DecodeBlock(other.data_.begin() + offset, other_block, count, isa);
+            simd::detail::Run<detail::HalfDotKernel>(isa, block, other_block, count, sums);
+        }
+        return detail::SumHalfLanes(sums);
+    }
+
+    float L2Distance(Span<const float> other, simd::Isa isa = simd::BestIsa()) const noexcept {
+        assert(other.Size() == Size());
+        float sums[detail::kHalfLanes] = {};
+        ForEachBlock(isa, [&sums, &other, isa](size_t offset, const float* block, size_t count) {
+            simd::detail::Run<detail::HalfL2Kernel>(isa, block, other.Data() + offset, count, sums);
+        });
+        return std::sqrt(detail::SumHalfLanes(sums));
+    }
+
+private:
+    // Кратен kHalfLanes, поэтому блоки не сдвигают распределение по суммам
+    static constexpr size_t kBlockSize = 64;
+    static_assert(kBlockSize % detail::kHalfLanes == 0);
+
+    static void EncodeBlock(const float* in, uint16_t* out, size_t count, simd::Isa isa) noexcept {
+        assert(simd::Supports(isa));
+        if constexpr (Format == HalfFormat::BF16) {
+            simd::detail::Run<detail::Bf16EncodeKernel>(isa, in, out, count);
+            return;
+        }
+#if VECTOR_SIMD_DISPATCH
+        if (isa == simd::Isa::kAvx512) {
+            detail::FloatToFp16Avx512(in, out, count);
+            return;
+        }
+        if (isa == simd::Isa::kAvx2) {
+            detail::FloatToFp16F16c(in, out, count);
+            return;
+        }
+#endif
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = Encode(in[i]);
+        }
+    }
+
+    static void DecodeBlock(const uint16_t* in, float* out, size_t count, simd::Isa isa) noexcept {
+        assert(simd::Supports(isa));
+        if constexpr (Format == HalfFormat::BF16) {
+            simd::detail::Run<detail::Bf16DecodeKernel>(isa, in, out, count);
+            return;
+        }
+#if VECTOR_SIMD_DISPATCH
+        if (isa == simd::Isa::kAvx512) {
+            detail::Fp16ToFloatAvx512(in, out, count);
+            return;
+        }
+        if (isa == simd::Isa::kAvx2) {
+            detail::Fp16ToFloatF16c(in, out, count);
+            return;
+        }
+#endif
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = Decode(in[i]);
+        }
+    }
+
+    // Распаковывает данные блоками во float-буфер на стеке
+    template <typename Func>
+    void ForEachBlock(simd::Isa isa, Func func) const noexcept {
+        float block[kBlockSize];
+        const uint16_t* in = data_.begin();
+        for (size_t offset = 0; offset < Size(); offset += kBlockSize) {
+            const size_t count = std::min(kBlockSize, Size() - offset);
+            DecodeBlock(in + offset, block, count, isa);
+            func(offset, block, count);
+        }
+    }
+
+    Vector<uint16_t> data_;
+};
+
+using Fp16Vector = HalfVector<HalfFormat::FP16>;
+using Bf16Vector = HalfVector<HalfFormat::BF16>;
@@ -0,0 +1,284 @@
+#pragma once
+
+#include "vector.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <utility>
+
+// Контейнер-"улей": элементы живут в блоках RawMemory<T> и никогда не
+// перемещаются, удаление оставляет дыру, которая переиспользуется
+// следующей вставкой. Серии удалённых ячеек описываются skip-полем:
+// первая и последняя ячейки серии хранят её длину, внутренние не
+// используются, у живых ячеек значение 0. Итерация перепрыгивает серию,
+// удаление и вставка обновляют только границы серий - всё за O(1).
+// Список свободных содержит ровно одну запись на серию
+template <typename T>
+class Hive {
+    struct Block {
+        explicit Block(uint32_t capacity)
+            : slots(capacity)
+            , skip(capacity + 1)
+            , free_entry(capacity) {
+        }
+
+        RawMemory<T> slots;
+        Vector<uint32_t> skip;
+        // Для первой ячейки серии - номер её записи в free_runs_
+        Vector<uint32_t> free_entry;
+        uint32_t high_water = 0;
+    };
+
+    // Серия удалённых ячеек по её первой ячейке
+    struct FreeRun {
+        uint32_t block;
+        uint32_t begin;
+    };
+
+public:
+    template <typename ValueType>
+    class BasicIterator {
+        friend class Hive;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::remove_const_t<ValueType>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = ValueType*;
+        using reference = ValueType&;
+
+        BasicIterator() = default;
+
+        reference operator*() const noexcept {
+            return hive_->blocks_[block_].slots[slot_];
+        }
+
+        pointer operator->() const noexcept {
+            return &**this;
+        }
+
+        BasicIterator& operator++() noexcept {
+            ++slot_;
+            SkipErased();
+            return *this;
+        }
+
+        BasicIterator operator++(int) noexcept {
+            BasicIterator copy(*this);
+            ++*this;
+            return copy;
+        }
+
+        friend bool operator==(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.block_ == rhs.block_ && lhs.slot_ == rhs.slot_;
+        }
+
+        friend bool operator!=(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return !(lhs == rhs);
+        }
+
+    private:
+        BasicIterator(const Hive* hive, size_t block, uint32_t slot) noexcept
+            : hive_(const_cast<Hive*>(hive))
+            , block_(block)
+            , slot_(slot) {
+        }
+
+        void SkipErased() noexcept {
+            while (block_ < hive_->blocks_.Size()) {
+                const Block& block = hive_->blocks_[block_];
+                if (slot_ < block.high_water) {
+                    slot_ += block.skip[slot_];
+                    if (slot_ < block.high_water) {
+                        return;
+                    }
+                }
+                ++block_;
+                slot_ = 0;
+            }
+            slot_ = 0;
+        }
+
+        Hive* hive_ = nullptr;
+        size_t block_ = 0;
+        uint32_t slot_ = 0;
+    };
+
+    using iterator = BasicIterator<T>;
+    using const_iterator = BasicIterator<const T>;
+
+    Hive() = default;
+
+    Hive(const Hive&) = delete;
+    Hive& operator=(const Hive&) = delete;
+
+    Hive(Hive&& other) noexcept {
+        Swap(other);
+    }
+
+    Hive& operator=(Hive&& rhs) noexcept {
+        if (this != &rhs) {
+            Swap(rhs);
+        }
+        return *this;
+    }
+
+    ~Hive() {
+        for (iterator it = begin(); it != end(); ++it) {
+            std::destroy_at(&*it);
+        }
+    }
+
+    void Swap(Hive& other) noexcept {
+        blocks_.Swap(other.blocks_);
+        free_runs_.Swap(other.free_runs_);
+        std::swap(size_, other.size_);
+    }
+
+    iterator begin() noexcept {
+        iterator it(this, 0, 0);
+        it.SkipErased();
+        return it;
+    }
+
+    iterator end() noexcept {
+        return iterator(this, blocks_.Size(), 0);
+    }
+
+    const_iterator begin() const noexcept {
+        const_iterator it(this, 0, 0);
+        it.SkipErased();
+        return it;
+    }
+
+    const_iterator end() const noexcept {
+        return const_iterator(this, blocks_.Size(), 0);
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    size_t Capacity() const noexcept {
+        size_t capacity = 0;
+        for (const Block& block : blocks_) {
+            capacity += block.slots.Capacity();
+        }
+        return capacity;
+    }
+
+    size_t BlockCount() const noexcept {
+        return blocks_.Size();
+    }
+
+    // Число серий удалённых ячеек, ожидающих переиспользования
+    size_t FreeRunCount() const noexcept {
+        return free_runs_.Size();
+    }
+
+    // Сначала занимается последняя ячейка последней освободившейся серии,
+    // затем свободное место последнего блока, и только потом выделяется
+    // новый блок
+    template <typename... Args>
+    iterator Emplace(Args&&... args) {
+        if (free_runs_.Size() > 0) {
+            const FreeRun run = free_runs_[free_runs_.Size() - 1];
+            Block& block = blocks_[run.block];
+            const uint32_t length = block.skip[run.begin];
+            const uint32_t slot = run.begin + length - 1;
+            new (block.slots + slot) T(std::forward<Args>(args)...);
+            block.skip[slot] = 0;
+            if (length == 1) {
+                free_runs_.PopBack();
+            } else {
+                block.skip[run.begin] = length - 1;
+                block.skip[slot - 1] = length - 1;
+            }
+            ++size_;
+            return iterator(this, run.block, slot);
+        }
+
+        if (blocks_.Size() == 0 || LastBlock().high_water == LastBlock().slots.Capacity()) {
+            const uint32_t capacity = blocks_.Size() == 0
+                ? kMinBlockCapacity
+                : std::min(kMaxBlockCapacity, static_cast<uint32_t>(LastBlock().slots.Capacity()) * 2);
+            blocks_.EmplaceBack(capacity);
+        }
+        Block& block = LastBlock();
+        new (block.slots + block.high_water) T(std::forward<Args>(args)...);
+        ++block.high_water;
+        ++size_;
+        return iterator(this, blocks_.Size() - 1, block.high_water - 1);
+    }
+
+    iterator Insert(const T& value) {
+        return Emplace(value);
+    }
+
+    iterator Insert(T&& value) {
+        return Emplace(std::move(value));
+    }
+
+    // Возвращает итератор на следующий живой элемент
+    iterator Erase(iterator pos) {
+        assert(pos.hive_ == this);
+        const auto block_index = static_cast<uint32_t>(pos.block_);
+        const uint32_t slot = pos.slot_;
+        if (free_runs_.Size() == free_runs_.Capacity()) {
+            free_runs_.Reserve(free_runs_.Size() == 0 ? 1 : free_runs_.Size() * 2);
+        }
+
+        Block& block = blocks_[block_index];
+        assert(slot < block.high_water && block.skip[slot] == 0);
+        std::destroy_at(block.slots + slot);
+        --size_;
+
+        // Длины соседних серий лежат в их граничных ячейках
+        const uint32_t left = slot > 0 ? block.skip[slot - 1] : 0;
+        const uint32_t right = block.skip[slot + 1];
+        const uint32_t run_begin = slot - left;
+        const uint32_t run_length = left + 1 + right;
+        block.skip[run_begin] = run_length;
+        block.skip[run_begin + run_length - 1] = run_length;
+        if (left != 0 && right != 0) {
+            // Серия справа поглощается левой
+            RemoveFreeRun(block.free_entry[slot + 1]);
+        } else if (right != 0) {
+            // Запись серии справа теперь описывает серию с начала slot
+            const uint32_t entry = block.free_entry[slot + 1];
+            free_runs_[entry].begin = slot;
+            block.free_entry[slot] = entry;
+        } else if (left == 0) {
+            block.free_entry[slot] = static_cast<uint32_t>(free_runs_.Size());
+            free_runs_.PushBack(FreeRun{block_index, slot});
+        }
+
+        iterator next(this, block_index, run_begin + run_length);
+        next.SkipErased();
+        return next;
+    }
+
+private:
+    static constexpr uint32_t kMinBlockCapacity = 8;
+    static constexpr uint32_t kMaxBlockCapacity = 1 << 16;
+
+    Block& LastBlock() noexcept {
+        return blocks_[blocks_.Size() - 1];
+    }
+
+    // Удаляет запись, перенося на её место последнюю
+    void RemoveFreeRun(uint32_t entry) noexcept {
+        const FreeRun last = free_runs_[free_runs_.Size() - 1];
+        free_runs_[entry] = last;
+        blocks_[last.block].free_entry[last.begin] = entry;
+        free_runs_.PopBack();
+    }
+
+    Vector<Block> blocks_;
+    Vector<FreeRun> free_runs_;
+    size_t size_ = 0;
+};
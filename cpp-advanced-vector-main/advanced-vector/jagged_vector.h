@@ -0,0 +1,166 @@
+#pragma once
+
+#include "span.h"
+#include "vector.h"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+// Вектор векторов в формате CSR: все значения лежат в одном Vector<T>,
+// второй вектор хранит конец каждой строки
+template <typename T>
+class JaggedVector {
+public:
+    // Двухпроходное построение: сначала Count для каждого значения,
+    // затем Allocate и Fill в том же или любом другом порядке
+    class Builder {
+    public:
+        explicit Builder(size_t row_count)
+            : cursors_(row_count) {
+        }
+
+        void Count(size_t row, size_t count = 1) noexcept {
+            assert(!allocated_);
+            cursors_[row] += count;
+        }
+
+        void Allocate() {
+            assert(!allocated_);
+            result_.ends_.Resize(cursors_.Size());
+            size_t total = 0;
+            for (size_t row = 0; row < cursors_.Size(); ++row) {
+                const size_t count = cursors_[row];
+                cursors_[row] = total;
+                total += count;
+                result_.ends_[row] = total;
+            }
+            result_.values_.Resize(total);
+            allocated_ = true;
+        }
+
+        template <typename U>
+        void Fill(size_t row, U&& value) {
+            assert(allocated_);
+            assert(cursors_[row] < result_.ends_[row]);
+            result_.values_[cursors_[row]++] = std::forward<U>(value);
+        }
+
+        JaggedVector Build() {
+            assert(allocated_);
+            allocated_ = false;
+            cursors_.Resize(0);
+            return std::move(result_);
+        }
+
+    private:
+        Vector<size_t> cursors_;
+        JaggedVector result_;
+        bool allocated_ = false;
+    };
+
+    JaggedVector() = default;
+
+    // Строит строки из списка рёбер (строка, значение), порядок внутри строки сохраняется
+    static JaggedVector FromEdges(size_t row_count, Span<const std::pair<size_t, T>> edges) {
+        Builder builder(row_count);
+        for (const auto& [row, value] : edges) {
+            builder.Count(row);
+        }
+        builder.Allocate();
+        for (const auto& [row, value] : edges) {
+            builder.Fill(row, value);
+        }
+        return builder.Build();
+    }
+
+    size_t RowCount() const noexcept {
+        return ends_.Size();
+    }
+
+    size_t ValueCount() const noexcept {
+        return values_.Size();
+    }
+
+    Span<T> Row(size_t row) noexcept {
+        assert(row < RowCount());
+        return Span<T>(values_.begin() + RowBegin(row), values_.begin() + ends_[row]);
+    }
+
+    Span<const T> Row(size_t row) const noexcept {
+        assert(row < RowCount());
+        return Span<const T>(values_.begin() + RowBegin(row), values_.begin() + ends_[row]);
+    }
+
+    Span<T> Values() noexcept {
+        return values_;
+    }
+
+    Span<const T> Values() const noexcept {
+        return values_;
+    }
+
+    void Reserve(size_t row_count, size_t value_count) {
+        ends_.Reserve(row_count);
+        values_.Reserve(value_count);
+    }
+
+    // Начинает новую пустую строку в конце
+    void AppendRow() {
+        ends_.PushBack(values_.Size());
+    }
+
+    // row не должна ссылаться на значения этого же вектора
+    void AppendRow(Span<const T> row) {
+        const size_t new_value_count = values_.Size() + row.Size();
+        if (new_value_count > values_.Capacity()) {
+            values_.Reserve(std::max(new_value_count, values_.Size() * 2));
+        }
+        const size_t old_value_count = values_.Size();
+        try {
+            for (const T& value : row) {
+                values_.PushBack(value);
+            }
+            AppendRow();
+        } catch (...) {
+            while (values_.Size() > old_value_count) {
+                values_.PopBack();
+            }
+            throw;
+        }
+    }
+
+    // Добавляет значение в последнюю строку
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args) {
+        assert(RowCount() > 0);
+        T& value = values_.EmplaceBack(std::forward<Args>(args)...);
+        ++ends_[RowCount() - 1];
+        return value;
+    }
+
+    void PushBack(const T& value) {
+        EmplaceBack(value);
+    }
+
+    void PushBack(T&& value) {
+        EmplaceBack(std::move(value));
+    }
+
+    void PopRow() noexcept {
+        assert(RowCount() > 0);
+        const size_t row_begin = RowBegin(RowCount() - 1);
+        while (values_.Size() > row_begin) {
+            values_.PopBack();
+        }
+        ends_.PopBack();
+    }
+
+private:
+    size_t RowBegin(size_t row) const noexcept {
+        return row == 0 ? 0 : ends_[row - 1];
+    }
+
+    Vector<T> values_;
+    Vector<size_t> ends_;
+};
@@ -0,0 +1,174 @@
+#pragma once
+
+#include "span.h"
+#include "vector.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+// Обученный индекс над отсортированным массивом чисел: кусочно-линейная
+// модель позиции от ключа с ошибкой не больше epsilon на ключах массива.
+// Отрезки строятся за один потоковый проход методом сужающегося конуса,
+// поиск предсказывает позицию и ищет двоичным поиском в окне ±epsilon.
+// Индекс не владеет данными: массив должен жить дольше индекса
+template <typename T>
+class LearnedIndex {
+    static_assert(std::is_arithmetic_v<T>, "LearnedIndex models numeric keys");
+
+    struct Segment {
+        T key;
+        double slope;
+        size_t position;
+    };
+
+public:
+    // Принимает ключи по неубыванию по одному, не храня их
+    class Builder {
+    public:
+        explicit Builder(size_t epsilon)
+            : epsilon_(static_cast<double>(epsilon)) {
+            result_.epsilon_ = epsilon;
+        }
+
+        void Add(T key) {
+            const size_t position = count_++;
+            if (position > 0 && !(last_key_ < key)) {
+                // Повторы ключа модель не различает: важна первая позиция
+                assert(!(key < last_key_));
+                return;
+            }
+            last_key_ = key;
+            if (position == 0) {
+                Open(key, position);
+                return;
+            }
+
+            const double dx = static_cast<double>(key) - static_cast<double>(origin_.key);
+            const double dy = static_cast<double>(position - origin_.position);
+            if (dx <= 0 || dy / dx < min_slope_ || dy / dx > max_slope_) {
+                Close();
+                Open(key, position);
+                return;
+            }
+            min_slope_ = std::max(min_slope_, (dy - epsilon_) / dx);
+            max_slope_ = std::min(max_slope_, (dy + epsilon_) / dx);
+        }
+
+        LearnedIndex Build(Span<const T> sorted) {
+            assert(sorted.Size() == count_);
+            if (count_ > 0) {
+                Close();
+            }
+            result_.data_ = sorted;
+            return std::move(result_);
+        }
+
+    private:
+        void Open(T key, size_t position) noexcept {
+            origin_ = Segment{key, 0.0, position};
+            min_slope_ = 0.0;
+            max_slope_ = std::numeric_limits<double>::infinity();
+        }
+
+        void Close() {
+            if (max_slope_ != std::numeric_limits<double>::infinity()) {
+                origin_.slope = (min_slope_ + max_slope_) / 2;
+            } else {
+                origin_.slope = min_slope_;
+            }
+            result_.segments_.PushBack(origin_);
+        }
+
+        LearnedIndex result_;
+        double epsilon_;
+        Segment origin_{};
+        double min_slope_ = 0.0;
+        double max_slope_ = 0.0;
+        T last_key_{};
+        size_t count_ = 0;
+    };
+
+    LearnedIndex() = default;
+
+    LearnedIndex(Span<const T> sorted, size_t epsilon) {
+        Builder builder(epsilon);
+        for (const T& key : sorted) {
+            builder.Add(key);
+        }
+        *this = builder.Build(sorted);
+    }
+
+    // Наименьшая точность, при которой модель укладывается в max_bytes
+    static LearnedIndex FromBudget(Span<const T> sorted, size_t max_bytes) {
+        size_t epsilon = kMinEpsilon;
+        LearnedIndex result(sorted, epsilon);
+        while (result.SizeBytes() > max_bytes && epsilon < sorted.Size()) {
+            epsilon *= 2;
+            result = LearnedIndex(sorted, epsilon);
+        }
+        return result;
+    }
+
+    size_t Size() const noexcept {
+        return data_.Size();
+    }
+
+    size_t Epsilon() const noexcept {
+        return epsilon_;
+    }
+
+    size_t SegmentCount() const noexcept {
+        return segments_.Size();
+    }
+
+    size_t SizeBytes() const noexcept {
+        return segments_.Size() * sizeof(Segment);
+    }
+
+    // Позиция первого ключа, не меньшего key, или Size()
+    size_t LowerBound(T key) const {
+        const size_t size = data_.Size();
+        if (size == 0) {
+            return 0;
+        }
+        const size_t predicted = Predict(key);
+        size_t first = predicted > epsilon_ ? predicted - epsilon_ : 0;
+        size_t last = std::min(size, predicted + epsilon_ + 1);
+
+        // Ключи вне массива и погрешность округления могут вывести ответ
+        // за окно; тогда окно расширяется экспоненциально
+        for (size_t step = epsilon_ + 1; first > 0 && !(data_[first - 1] < key); step *= 2) {
+            last = first;
+            first = first > step ? first - step : 0;
+        }
+        for (size_t step = epsilon_ + 1; last < size && data_[last - 1] < key; step *= 2) {
+            first = last;
+            last = std::min(size, last + step);
+        }
+        return std::lower_bound(data_.begin() + first, data_.begin() + last, key) - data_.begin();
+    }
+
+private:
+    static constexpr size_t kMinEpsilon = 16;
+
+    size_t Predict(T key) const noexcept {
+        auto segment = std::upper_bound(segments_.begin(), segments_.end(), key,
+                                        [](T lhs, const Segment& rhs) {
+                                            return lhs < rhs.key;
+                                        });
+        if (segment == segments_.begin()) {
+            return 0;
+        }
+        --segment;
+        const double offset = segment->slope * (static_cast<double>(key) - static_cast<double>(segment->key));
+        const double position = static_cast<double>(segment->position) + std::round(offset);
+        return static_cast<size_t>(std::clamp(position, 0.0, static_cast<double>(data_.Size() - 1)));
+    }
+
+    Span<const T> data_;
+    Vector<Segment> segments_;
+    size_t epsilon_ = 0;
+};
@@ -0,0 +1,290 @@
+#pragma once
+
+#include "flat_hash_map.h"
+#include "vector.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <utility>
+
+// LRU-кеш фиксированной ёмкости. Записи лежат в заранее выделенном
+// Vector и связаны в список индексами prev/next, ключ ищется по таблице
+// с открытой адресацией (линейное пробирование, удаление сдвигом назад).
+// После конструктора ни попадание, ни вставка, ни вытеснение не выделяют
+// память: вытесняемая запись переиспользуется на месте
+template <typename K, typename V, typename Hash = std::hash<K>, typename Eq = std::equal_to<K>>
+class LruCache {
+public:
+    struct Stats {
+        size_t hits = 0;
+        size_t misses = 0;
+        size_t evictions = 0;
+    };
+
+    explicit LruCache(size_t capacity, Hash hash = Hash(), Eq eq = Eq())
+        : index_(TableSizeFor(capacity))
+        , hash_(std::move(hash))
+        , eq_(std::move(eq)) {
+        assert(capacity > 0 && capacity < kNone);
+        entries_.Reserve(capacity);
+        std::fill(index_.begin(), index_.end(), kNone);
+    }
+
+    // Копия сохраняет ёмкость и порядок использования; записи
+    // укладываются подряд, таблица индексов строится заново
+    LruCache(const LruCache& other)
+        : index_(other.index_.Size())
+        , stats_(other.stats_)
+        , hash_(other.hash_)
+        , eq_(other.eq_) {
+        entries_.Reserve(other.Capacity());
+        std::fill(index_.begin(), index_.end(), kNone);
+        for (uint32_t slot = other.tail_; slot != kNone; slot = other.entries_[slot].prev) {
+            const Entry& entry = other.entries_[slot];
+            entries_.EmplaceBack(Entry{entry.key, entry.value, kNone, kNone});
+            const uint32_t copy = static_cast<uint32_t>(entries_.Size() - 1);
+            PushFront(copy);
+            AddToIndex(copy);
+        }
+        size_ = other.size_;
+    }
+
+    // Исходный кеш остаётся пустым с нулевой ёмкостью: поиск в нём
+    // всегда промахивается, а вставленная запись сразу вытесняется
+    LruCache(LruCache&& other) noexcept
+        : hash_(other.hash_)
+        , eq_(other.eq_) {
+        Swap(other);
+    }
+
+    LruCache& operator=(const LruCache& rhs) {
+        if (this != &rhs) {
+            LruCache rhs_copy(rhs);
+            Swap(rhs_copy);
+        }
+        return *this;
+    }
+
+    LruCache& operator=(LruCache&& rhs) noexcept {
+        if (this != &rhs) {
+            Swap(rhs);
+        }
+        return *this;
+    }
+
+    void Swap(LruCache& other) noexcept {
+        entries_.Swap(other.entries_);
+        index_.Swap(other.index_);
+        std::swap(head_, other.head_);
+        std::swap(tail_, other.tail_);
+        std::swap(free_head_, other.free_head_);
+        std::swap(size_, other.size_);
+        std::swap(stats_, other.stats_);
+        std::swap(hash_, other.hash_);
+        std::swap(eq_, other.eq_);
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    size_t Capacity() const noexcept {
+        return entries_.Capacity();
+    }
+
+    const Stats& GetStats() const noexcept {
+        return stats_;
+    }
+
+    void ResetStats() noexcept {
+        stats_ = Stats{};
+    }
+
+    // Значение по ключу с продвижением записи в начало списка;
+    // nullptr при промахе
+    V* Get(const K& key) {
+        const uint32_t slot = FindSlot(key);
+        if (slot == kNone) {
+            ++stats_.misses;
+            return nullptr;
+        }
+        ++stats_.hits;
+        MoveToFront(slot);
+        return &entries_[slot].value;
+    }
+
+    // Поиск без продвижения и без учёта в статистике
+    const V* Peek(const K& key) const {
+        const uint32_t slot = FindSlot(key);
+        return slot == kNone ? nullptr : &entries_[slot].value;
+    }
+
+    bool Contains(const K& key) const {
+        return FindSlot(key) != kNone;
+    }
+
+    // Вставляет или обновляет значение. При заполненном кеше вытесняется
+    // давно не использованная запись. Возвращает false, если ключ уже был
+    bool Put(const K& key, V value) {
+        if (const uint32_t slot = FindSlot(key); slot != kNone) {
+            entries_[slot].value = std::move(value);
+            MoveToFront(slot);
+            return false;
+        }
+        if (entries_.Capacity() == 0) {
+            ++stats_.evictions;
+            return true;
+        }
+
+        uint32_t slot = kNone;
+        if (free_head_ == kNone && entries_.Size() < entries_.Capacity()) {
+            entries_.EmplaceBack(Entry{key, std::move(value), kNone, kNone});
+            slot = static_cast<uint32_t>(entries_.Size() - 1);
+        } else {
+            if (free_head_ != kNone) {
+                slot = free_head_;
+                free_head_ = entries_[slot].next;
+            } else {
+                slot = tail_;
+                Unlink(slot);
+                RemoveFromIndex(slot);
+                --size_;
+                ++stats_.evictions;
+            }
+            try {
+                entries_[slot].key = key;
+                entries_[slot].value = std::move(value);
+            } catch (...) {
+                // Запись с частично присвоенными полями уходит в свободные
+                entries_[slot].next = free_head_;
+                free_head_ = slot;
+                throw;
+            }
+        }
+        PushFront(slot);
+        AddToIndex(slot);
+        ++size_;
+        return true;
+    }
+
+    bool Erase(const K& key) {
+        const uint32_t slot = FindSlot(key);
+        if (slot == kNone) {
+            return false;
+        }
+        Unlink(slot);
+        RemoveFromIndex(slot);
+        entries_[slot].next = free_head_;
+        free_head_ = slot;
+        --size_;
+        return true;
+    }
+
+    // Обход от самой свежей записи к самой старой
+    template <typename Func>
+    void ForEach(Func func) const {
+        for (uint32_t slot = head_; slot != kNone; slot = entries_[slot].next) {
+            func(entries_[slot].key, entries_[slot].value);
+        }
+    }
+
+private:
+    static constexpr uint32_t kNone = UINT32_MAX;
+
+    // Освобождённые записи остаются сконструированными и хранятся
+    // в списке свободных через next
+    struct Entry {
+        K key;
+        V value;
+        uint32_t prev;
+        uint32_t next;
+    };
+
+    // Таблица заполнена не более чем наполовину
+    static size_t TableSizeFor(size_t capacity) noexcept {
+        size_t size = 2;
+        while (size < capacity * 2) {
+            size *= 2;
+        }
+        return size;
+    }
+
+    size_t HomeOf(const K& key) const {
+        return detail::MixHash(hash_(key)) & (index_.Size() - 1);
+    }
+
+    uint32_t FindSlot(const K& key) const {
+        // Таблицы нет только у кеша, из которого переместили данные
+        if (index_.Size() == 0) {
+            return kNone;
+        }
+        const size_t mask = index_.Size() - 1;
+        for (size_t i = HomeOf(key);; i = (i + 1) & mask) {
+            const uint32_t slot = index_[i];
+            if (slot == kNone || eq_(entries_[slot].key, key)) {
+                return slot;
+            }
+        }
+    }
+
+    void AddToIndex(uint32_t slot) {
+        const size_t mask = index_.Size() - 1;
+        size_t i = HomeOf(entries_[slot].key);
+        while (index_[i] != kNone) {
+            i = (i + 1) & mask;
+        }
+        index_[i] = slot;
+    }
+
+    // Удаление со сдвигом назад: последующие записи цепочки подтягиваются
+    // в освободившуюся ячейку, поэтому таблица обходится без надгробий
+    void RemoveFromIndex(uint32_t slot) {
+        const size_t mask = index_.Size() - 1;
+        size_t hole = HomeOf(entries_[slot].key);
+        while (index_[hole] != slot) {
+            hole = (hole + 1) & mask;
+        }
+        for (size_t i = (hole + 1) & mask; index_[i] != kNone; i = (i + 1) & mask) {
+            const size_t home = HomeOf(entries_[index_[i]].key);
+            // Запись можно перенести, если дыра лежит между её домашней ячейкой и i
+            if (((i - home) & mask) >= ((i - hole) & mask)) {
+                index_[hole] = index_[i];
+                hole = i;
+            }
+        }
+        index_[hole] = kNone;
+    }
+
+    void Unlink(uint32_t slot) noexcept {
+        Entry& entry = entries_[slot];
+        (entry.prev == kNone ? head_ : entries_[entry.prev].next) = entry.next;
+        (entry.next == kNone ? tail_ : entries_[entry.next].prev) = entry.prev;
+    }
+
+    void PushFront(uint32_t slot) noexcept {
+        Entry& entry = entries_[slot];
+        entry.prev = kNone;
+        entry.next = head_;
+        (head_ == kNone ? tail_ : entries_[head_].prev) = slot;
+        head_ = slot;
+    }
+
+    void MoveToFront(uint32_t slot) noexcept {
+        if (slot != head_) {
+            Unlink(slot);
+            PushFront(slot);
+        }
+    }
+
+    Vector<Entry> entries_;
+    Vector<uint32_t> index_;
+    uint32_t head_ = kNone;
+    uint32_t tail_ = kNone;
+    uint32_t free_head_ = kNone;
+    size_t size_ = 0;
+    Stats stats_;
+    Hash hash_;
+    Eq eq_;
+};
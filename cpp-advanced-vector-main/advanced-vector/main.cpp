@@ -1,8 +1,35 @@
+#include "batch_lookup.h"
+#include "bit_vector.h"
+#include "dary_heap.h"
+#include "dict_vector.h"
+#include "eytzinger_index.h"
+#include "flat_hash_map.h"
+#include "flat_map.h"
+#include "half_vector.h"
+#include "hive.h"
+#include "jagged_vector.h"
+#include "learned_index.h"
+#include "lru_cache.h"
+#include "merge_k.h"
+#include "nullable_vector.h"
+#include "packed_int_vector.h"
+#include "permutation.h"
+#include "poly_vector.h"
+#include "prefix_sum_vector.h"
+#include "radix_sort.h"
+#include "rle_vector.h"
+#include "slot_map.h"
+#include "soa_vector.h"
+#include "string_vector.h"
 #include "vector.h"
+#include "vector_simd.h"
+#include "window_aggregator.h"
 
 #include <iostream>
+#include <sstream>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 
 namespace {
 
@@ -380,6 +407,2006 @@ void Test5() {
     }
 }
 
+void Test6() {
+    const int ID = 42;
+    const size_t SIZE = 100;
+    using namespace std::literals;
+    {
+        SoAVector<int, double, std::string> v;
+        assert(v.Size() == 0);
+        assert(v.Capacity() == 0);
+        for (size_t i = 0; i < SIZE; ++i) {
+            v.EmplaceBack(static_cast<int>(i), i * 0.5, std::to_string(i));
+        }
+        assert(v.Size() == SIZE);
+        assert(v.Capacity() >= SIZE);
+
+        auto ids = v.Column<0>();
+        auto weights = v.Column<1>();
+        assert(ids.Size() == SIZE);
+        assert(ids[ID] == ID);
+        assert(weights[ID] == ID * 0.5);
+        assert(v.Column<2>()[ID] == std::to_string(ID));
+
+        // Доступ по строкам через прокси-ссылку
+        auto [id, weight, name] = v[ID];
+        assert(id == ID);
+        assert(weight == ID * 0.5);
+        assert(name == std::to_string(ID));
+        std::get<0>(v[ID]) = -ID;
+        assert(ids[ID] == -ID);
+
+        v.Erase(0);
+        assert(v.Size() == SIZE - 1);
+        assert(std::get<0>(v[0]) == 1);
+        assert(std::get<2>(v[0]) == "1"s);
+        v.PopBack();
+        assert(v.Size() == SIZE - 2);
+
+        const auto v_copy(v);
+        assert(v_copy.Size() == v.Size());
+        assert(std::get<2>(v_copy[10]) == std::get<2>(v[10]));
+        assert(&std::get<1>(v_copy[10]) != &std::get<1>(v[10]));
+    }
+    {
+        Obj::ResetCounters();
+        {
+            SoAVector<int, Obj> v(SIZE);
+            assert(Obj::num_default_constructed == SIZE);
+            v.Reserve(SIZE * 2);
+            assert(v.Capacity() == SIZE * 2);
+            assert(Obj::num_moved == SIZE);
+            assert(Obj::num_copied == 0);
+            v.Resize(SIZE / 2);
+            assert(Obj::GetAliveObjectCount() == SIZE / 2);
+            v.EmplaceBack(ID, Obj{ID});
+            assert(std::get<1>(v[SIZE / 2]).id == ID);
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+    {
+        Obj::ResetCounters();
+        Obj::default_construction_throw_countdown = SIZE / 2;
+        try {
+            SoAVector<std::string, Obj> v(SIZE);
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+    {
+        SoAVector<TestObj> v(1);
+        assert(v.Size() == v.Capacity());
+        // Добавление существующего элемента должно быть безопасно при реаллокации
+        v.EmplaceBack(std::get<0>(v[0]));
+        assert(std::get<0>(v[0]).IsAlive());
+        assert(std::get<0>(v[1]).IsAlive());
+    }
+}
+
+namespace {
+
+struct Shape {
+    virtual ~Shape() = default;
+    virtual int Area() const = 0;
+};
+
+struct Square : Shape {
+    explicit Square(int side)
+        : side(side) {
+    }
+    int Area() const override {
+        return side * side;
+    }
+    int side;
+};
+
+struct Label : Shape {
+    Label(std::string text, Obj obj)
+        : text(std::move(text))
+        , obj(std::move(obj)) {
+    }
+    int Area() const override {
+        return static_cast<int>(text.size());
+    }
+    std::string text;
+    Obj obj;
+};
+
+}  // namespace
+
+void Test7() {
+    const int SIZE = 100;
+    using namespace std::literals;
+    {
+        Obj::ResetCounters();
+        {
+            PolyVector<Shape> v;
+            assert(v.Size() == 0);
+            for (int i = 0; i < SIZE; ++i) {
+                if (i % 2 == 0) {
+                    v.EmplaceBack<Square>(i);
+                } else {
+                    auto& label = v.EmplaceBack<Label>(std::to_string(i), Obj{i});
+                    assert(label.obj.id == i);
+                }
+            }
+            assert(v.Size() == SIZE);
+            assert(v.SizeBytes() <= v.CapacityBytes());
+            assert(v[4].Area() == 16);
+            assert(v[11].Area() == 2);
+            assert(dynamic_cast<const Label&>(v[11]).text == "11"s);
+            assert(Obj::GetAliveObjectCount() == SIZE / 2);
+
+            int total_area = 0;
+            for (const Shape& shape : v) {
+                total_area += shape.Area();
+            }
+            int expected_area = 0;
+            for (int i = 0; i < SIZE; ++i) {
+                expected_area += i % 2 == 0 ? i * i : static_cast<int>(std::to_string(i).size());
+            }
+            assert(total_area == expected_area);
+            assert(v.end() - v.begin() == SIZE);
+
+            v.PopBack();
+            assert(v.Size() == SIZE - 1);
+            assert(Obj::GetAliveObjectCount() == SIZE / 2 - 1);
+
+            PolyVector<Shape> moved(std::move(v));
+            assert(moved.Size() == SIZE - 1);
+            assert(moved[4].Area() == 16);
+            moved.Clear();
+            assert(moved.Size() == 0);
+            assert(Obj::GetAliveObjectCount() == 0);
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+    {
+        Obj::ResetCounters();
+        PolyVector<Shape> v;
+        v.Reserve(SIZE, SIZE * sizeof(Label));
+        const size_t capacity = v.CapacityBytes();
+        for (int i = 0; i < SIZE; ++i) {
+            v.EmplaceBack<Label>("x"s, Obj{i});
+        }
+        assert(v.CapacityBytes() == capacity);
+        assert(Obj::num_copied == 0);
+    }
+}
+
+void Test8() {
+    const size_t SIZE = 1000;
+    using namespace std::literals;
+    {
+        StringVector v;
+        assert(v.Empty());
+        for (size_t i = 0; i < SIZE; ++i) {
+            const auto value = v.EmplaceBack(std::to_string(SIZE - i));
+            assert(value == std::to_string(SIZE - i));
+        }
+        v.PushBack(""sv);
+        assert(v.Size() == SIZE + 1);
+        assert(v[0] == "1000"sv);
+        assert(v[SIZE - 1] == "1"sv);
+        assert(v[SIZE].empty());
+
+        v.PopBack();
+        assert(v.Size() == SIZE);
+        const size_t chars = v.CharCount();
+        v.PopBack();
+        assert(v.CharCount() == chars - 1);
+
+        v.Sort();
+        for (size_t i = 1; i < v.Size(); ++i) {
+            assert(v[i - 1] <= v[i]);
+        }
+        assert(v[0] == "10"sv);
+
+        std::stringstream stream;
+        v.WriteTo(stream);
+        const StringVector restored = StringVector::ReadFrom(stream);
+        assert(restored.Size() == v.Size());
+        for (size_t i = 0; i < v.Size(); ++i) {
+            assert(restored[i] == v[i]);
+        }
+    }
+    {
+        std::stringstream stream("garbage"s);
+        try {
+            StringVector::ReadFrom(stream);
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+    }
+    {
+        // Заголовок обещает больше данных, чем есть в потоке
+        const uint64_t header[2] = {uint64_t{1} << 40, 3};
+        std::stringstream stream(std::string(reinterpret_cast<const char*>(header), sizeof(header)) + "abc"s);
+        try {
+            StringVector::ReadFrom(stream);
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+    }
+    {
+        // Добавление строки из собственной арены при перевыделении памяти
+        StringVector v;
+        v.PushBack("self"sv);
+        for (int i = 0; i < 20; ++i) {
+            v.PushBack(v[v.Size() - 1]);
+            v.PushBack(v[0]);
+        }
+        assert(v.Size() == 41);
+        for (size_t i = 0; i < v.Size(); ++i) {
+            assert(v[i] == "self"sv);
+        }
+    }
+}
+
+void Test9() {
+    const size_t ROWS = 100;
+    {
+        JaggedVector<int> v;
+        assert(v.RowCount() == 0);
+        for (size_t row = 0; row < ROWS; ++row) {
+            v.AppendRow();
+            for (size_t i = 0; i < row % 5; ++i) {
+                v.PushBack(static_cast<int>(row * 10 + i));
+            }
+        }
+        assert(v.RowCount() == ROWS);
+        assert(v.Row(0).Empty());
+        assert(v.Row(7).Size() == 2);
+        assert(v.Row(7)[1] == 71);
+
+        const int extra[] = {1, 2, 3};
+        v.AppendRow(Span<const int>(extra, 3));
+        assert(v.RowCount() == ROWS + 1);
+        assert(v.Row(ROWS).Size() == 3);
+        assert(v.Row(ROWS)[2] == 3);
+
+        const size_t values = v.ValueCount();
+        v.PopRow();
+        assert(v.RowCount() == ROWS);
+        assert(v.ValueCount() == values - 3);
+    }
+    {
+        // Списки смежности из списка рёбер
+        Vector<std::pair<size_t, int>> edges;
+        edges.PushBack({2, 20});
+        edges.PushBack({0, 1});
+        edges.PushBack({2, 21});
+        edges.PushBack({0, 2});
+        edges.PushBack({3, 30});
+        const auto graph = JaggedVector<int>::FromEdges(4, edges);
+        assert(graph.RowCount() == 4);
+        assert(graph.ValueCount() == edges.Size());
+        assert(graph.Row(0).Size() == 2 && graph.Row(0)[0] == 1 && graph.Row(0)[1] == 2);
+        assert(graph.Row(1).Empty());
+        assert(graph.Row(2).Size() == 2 && graph.Row(2)[0] == 20 && graph.Row(2)[1] == 21);
+        assert(graph.Row(3).Size() == 1 && graph.Row(3)[0] == 30);
+    }
+    {
+        Obj::ResetCounters();
+        {
+            JaggedVector<Obj>::Builder builder(ROWS);
+            for (size_t row = 0; row < ROWS; ++row) {
+                builder.Count(row, row % 3);
+            }
+            builder.Allocate();
+            for (size_t row = ROWS; row-- > 0;) {
+                for (size_t i = 0; i < row % 3; ++i) {
+                    builder.Fill(row, Obj{static_cast<int>(row)});
+                }
+            }
+            const auto v = builder.Build();
+            assert(v.RowCount() == ROWS);
+            assert(v.Row(5).Size() == 2);
+            assert(v.Row(5)[1].id == 5);
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+}
+
+void Test10() {
+    const size_t SIZE = 1000;
+    {
+        BitVector bits;
+        for (size_t i = 0; i < SIZE; ++i) {
+            bits.PushBack(i % 3 == 0);
+        }
+        assert(bits.Size() == SIZE);
+        assert(bits.WordCount() == (SIZE + 63) / 64);
+        assert(bits[0] && !bits[1] && bits[999]);
+        assert(bits.Count() == (SIZE + 2) / 3);
+        assert(bits.FindFirst() == 0);
+        assert(bits.FindFirst(1) == 3);
+        assert(bits.FindFirst(SIZE) == SIZE);
+
+        bits[1] = true;
+        assert(bits.Test(1));
+        bits[1] = bits[2];
+        assert(!bits[1]);
+
+        bits.PopBack();
+        assert(bits.Size() == SIZE - 1);
+        assert(bits.Count() == (SIZE + 2) / 3 - 1);
+        bits.Resize(SIZE + 10, true);
+        assert(bits.Count() == (SIZE + 2) / 3 - 1 + 11);
+        bits.Resize(10);
+        assert(bits.Count() == 4);
+        bits.Resize(200);
+        assert(bits.Count() == 4);
+        assert(bits.FindFirst(10) == 200);
+    }
+    {
+        BitVector evens(SIZE);
+        BitVector threes(SIZE);
+        for (size_t i = 0; i < SIZE; ++i) {
+            evens.Set(i, i % 2 == 0);
+            threes.Set(i, i % 3 == 0);
+        }
+        BitVector both = evens;
+        both &= threes;
+        assert(both.Count() == (SIZE + 5) / 6);
+        BitVector any = evens;
+        any |= threes;
+        assert(any.Count() == evens.Count() + threes.Count() - both.Count());
+        BitVector exactly_one = evens;
+        exactly_one ^= threes;
+        assert(exactly_one.Count() == any.Count() - both.Count());
+        BitVector only_evens = evens;
+        only_evens.AndNot(threes);
+        assert(only_evens.Count() == evens.Count() - both.Count());
+        assert(!only_evens[6] && only_evens[4]);
+    }
+    {
+        BitVector bits(SIZE * 3);
+        for (size_t i = 0; i < bits.Size(); i += 7) {
+            bits.Set(i);
+        }
+        assert(!bits.HasRankIndex());
+        bits.BuildRankIndex();
+        assert(bits.HasRankIndex());
+        size_t expected_rank = 0;
+        for (size_t i = 0; i <= bits.Size(); ++i) {
+            assert(bits.Rank(i) == expected_rank);
+            if (i < bits.Size() && bits[i]) {
+                assert(bits.Select(expected_rank) == i);
+                ++expected_rank;
+            }
+        }
+        assert(bits.Select(expected_rank) == bits.Size());
+        bits.Set(1);
+        assert(!bits.HasRankIndex());
+    }
+    for (simd::Isa isa : {simd::Isa::kBaseline, simd::Isa::kAvx2, simd::Isa::kAvx512}) {
+        if (!simd::Supports(isa)) {
+            continue;
+        }
+        // Каждый вариант подсчёта совпадает с побитовым, в том числе
+        // на неполном последнем блоке индекса
+        for (size_t size : {size_t{0}, size_t{64}, size_t{511}, size_t{512}, SIZE * 3 + 5}) {
+            BitVector bits(size);
+            size_t expected_count = 0;
+            for (size_t i = 0; i < size; ++i) {
+                if ((i * 2654435761u) % 5 < 2) {
+                    bits.Set(i);
+                    ++expected_count;
+                }
+            }
+            assert(bits.Count(isa) == expected_count);
+            bits.BuildRankIndex(isa);
+            size_t expected_rank = 0;
+            for (size_t i = 0; i <= size; i += 13) {
+                assert(bits.Rank(i) == expected_rank);
+                for (size_t j = i; j < std::min(i + 13, size); ++j) {
+                    expected_rank += bits[j];
+                }
+            }
+            assert(bits.Rank(size) == expected_count);
+        }
+    }
+}
+
+void Test11() {
+    const size_t SIZE = 1000;
+    {
+        NullableVector<double> v;
+        assert(!v.Min());
+        assert(v.Sum() == 0.0);
+        for (size_t i = 0; i < SIZE; ++i) {
+            v.PushBack(static_cast<double>(i));
+        }
+        assert(v.NullCount() == 0);
+        assert(v.Sum() == SIZE * (SIZE - 1) / 2.0);
+        assert(*v.Min() == 0.0);
+        assert(*v.Max() == SIZE - 1.0);
+    }
+    {
+        NullableVector<int64_t> v;
+        int64_t expected_sum = 0;
+        size_t expected_nulls = 0;
+        for (size_t i = 0; i < SIZE; ++i) {
+            if (i % 5 == 0 || (i >= 128 && i < 192)) {
+                v.PushNull();
+                ++expected_nulls;
+            } else {
+                v.PushBack(static_cast<int64_t>(i));
+                expected_sum += static_cast<int64_t>(i);
+            }
+        }
+        assert(v.Size() == SIZE);
+        assert(!v[0] && v[1] && *v[1] == 1);
+        assert(v.NullCount() == expected_nulls);
+        assert(v.Sum() == expected_sum);
+        assert(*v.Min() == 1);
+        assert(*v.Max() == SIZE - 1);
+
+        const auto large = v.Filter([](int64_t value) {
+            return value > 990;
+        });
+        assert(large.Size() == 8);
+        assert(large[0] == 991 && large[7] == 999);
+
+        v.SetNull(999);
+        assert(*v.Max() == 998);
+        v.Set(0, -1);
+        assert(v.IsValid(0));
+        assert(*v.Min() == -1);
+        v.PushBack(std::optional<int64_t>{});
+        assert(!v[SIZE]);
+        v.PopBack();
+        assert(v.Size() == SIZE);
+        assert(v.NullCount() == expected_nulls);
+    }
+    {
+        // Сумма не переполняет тип элементов
+        NullableVector<int8_t> v;
+        for (size_t i = 0; i < 300; ++i) {
+            v.PushBack(int8_t{1});
+            v.PushNull();
+        }
+        assert(v.Sum() == 300);
+        NullableVector<uint8_t> bytes;
+        for (size_t i = 0; i < 10; ++i) {
+            bytes.PushBack(uint8_t{200});
+        }
+        assert(bytes.Sum() == 2000);
+    }
+    {
+        using namespace std::literals;
+        NullableVector<std::string> v;
+        v.PushBack("abc");
+        v.PushBack("de"s);
+        const std::string word = "fgh"s;
+        v.PushBack(word);
+        v.PushBack(std::optional<std::string>{"ij"});
+        v.PushBack(std::optional<std::string>{});
+        const std::optional<std::string> missing;
+        v.PushBack(missing);
+        assert(v.Size() == 6 && v.NullCount() == 2);
+        assert(*v[0] == "abc"s && *v[1] == "de"s && *v[2] == "fgh"s && *v[3] == "ij"s);
+        assert(!v[4] && !v[5]);
+        assert(*v.Min() == "abc"s && *v.Max() == "ij"s);
+    }
+}
+
+void Test12() {
+    const size_t SIZE = 100'000;
+    using namespace std::literals;
+    {
+        const std::string cities[] = {"Moscow"s, "Kazan"s, "Omsk"s};
+        DictVector<std::string> v;
+        for (size_t i = 0; i < SIZE; ++i) {
+            v.PushBack(cities[i % 3]);
+        }
+        assert(v.Size() == SIZE);
+        assert(v.Cardinality() == 3);
+        assert(v.CodeWidth() == 1);
+        assert(v[4] == "Kazan"s);
+        assert(v.Count("Omsk"s) == SIZE / 3);
+        assert(v.Count("Tver"s) == 0);
+        assert(v.FindAll("Moscow"s).Size() == (SIZE + 2) / 3);
+        assert(v.FindAll("Moscow"s)[1] == 3);
+
+        const auto counts = v.CountByCode();
+        assert(counts.Size() == 3);
+        assert(counts[*v.FindCode("Kazan"s)] == SIZE / 3);
+        v.PopBack();
+        assert(v.Size() == SIZE - 1);
+    }
+    {
+        DictVector<uint64_t> v;
+        for (uint64_t i = 0; i < 256; ++i) {
+            v.PushBack(i * 1000);
+        }
+        assert(v.CodeWidth() == 1);
+        v.PushBack(256'000);
+        assert(v.CodeWidth() == 2);
+        assert(v[255] == 255'000);
+        assert(v[256] == 256'000);
+        for (uint64_t i = 257; i <= 70'000; ++i) {
+            v.PushBack(i * 1000);
+        }
+        assert(v.CodeWidth() == 4);
+        assert(v.Cardinality() == 70'001);
+        assert(v[300] == 300'000);
+        assert(v.CodeAt(70'000) == 70'000);
+        for (uint64_t i = 0; i <= 70'000; i += 997) {
+            assert(v.FindCode(i * 1000) == i);
+        }
+        assert(!v.FindCode(1));
+    }
+    {
+        // Одинаковый хеш у всех значений: коды различаются только сравнением
+        struct ConstantHash {
+            size_t operator()(const std::string&) const noexcept {
+                return 42;
+            }
+        };
+        DictVector<std::string, ConstantHash> v;
+        assert(!v.FindCode("a"s));
+        for (int i = 0; i < 100; ++i) {
+            v.PushBack(std::to_string(i % 50));
+        }
+        assert(v.Cardinality() == 50);
+        assert(*v.FindCode("49"s) == 49 && !v.FindCode("50"s));
+        assert(v.Count("7"s) == 2);
+
+        DictVector<std::string, ConstantHash> copy(v);
+        copy.PushBack("new"s);
+        assert(copy.Cardinality() == 51 && v.Cardinality() == 50);
+        assert(*copy.FindCode("new"s) == 50 && !v.FindCode("new"s));
+        DictVector<std::string, ConstantHash> moved(std::move(copy));
+        assert(*moved.FindCode("new"s) == 50);
+    }
+}
+
+void Test13() {
+    const size_t RUN = 1000;
+    {
+        RleVector<int> v;
+        assert(v.Size() == 0);
+        assert(v.begin() == v.end());
+        v.PushBack(1, RUN);
+        v.PushBack(2);
+        v.PushBack(2);
+        v.PushBack(1, RUN);
+        v.PushBack(1);
+        v.PushBack(3, 0);
+        assert(v.Size() == RUN * 2 + 3);
+        assert(v.RunCount() == 3);
+        assert(v[0] == 1);
+        assert(v[RUN - 1] == 1);
+        assert(v[RUN] == 2);
+        assert(v[RUN + 1] == 2);
+        assert(v[RUN + 2] == 1);
+        assert(v[RUN * 2 + 2] == 1);
+        assert(v.Count(1) == RUN * 2 + 1);
+        assert(v.Count(3) == 0);
+        assert(v.Sum() == static_cast<int>(RUN * 2 + 1 + 4));
+
+        size_t visited = 0;
+        int sum = 0;
+        for (const int value : v) {
+            sum += value;
+            ++visited;
+        }
+        assert(visited == v.Size());
+        assert(sum == v.Sum());
+
+        // Сумма серии int8_t не переполняется
+        RleVector<int8_t> ones;
+        ones.PushBack(1, 300);
+        ones.PushBack(-2, 10);
+        assert(ones.Sum() == 280);
+        RleVector<uint8_t> bytes;
+        bytes.PushBack(200, RUN);
+        assert(bytes.Sum() == 200 * RUN);
+
+        v.PopBack();
+        v.PopBack();
+        assert(v.Size() == RUN * 2 + 1);
+        for (size_t i = 0; i < RUN; ++i) {
+            v.PopBack();
+        }
+        assert(v.RunCount() == 2);
+        assert(v[RUN] == 2);
+    }
+    {
+        Vector<std::string> plain;
+        for (size_t i = 0; i < RUN; ++i) {
+            plain.PushBack(i < RUN / 2 ? "ok" : (i % 100 < 50 ? "warn" : "fail"));
+        }
+        const RleVector<std::string> encoded(plain);
+        assert(encoded.Size() == RUN);
+        assert(encoded.RunCount() == 1 + 10);
+        const auto decoded = encoded.ToVector();
+        assert(decoded.Size() == plain.Size());
+        assert(std::equal(plain.begin(), plain.end(), decoded.begin()));
+        assert(std::equal(encoded.begin(), encoded.end(), plain.begin()));
+    }
+}
+
+void Test14() {
+    const size_t SIZE = 10'000;
+    {
+        // Отсортированные метки времени с небольшим шагом
+        PackedIntVector v;
+        Vector<uint64_t> plain;
+        uint64_t timestamp = 1'700'000'000'000;
+        for (size_t i = 0; i < SIZE; ++i) {
+            timestamp += 1 + i % 17;
+            v.PushBack(timestamp);
+            plain.PushBack(timestamp);
+        }
+        assert(v.Size() == SIZE);
+        assert(v.BlockCount() == SIZE / PackedIntVector::kBlockSize);
+        assert(v.MemoryBytes() * 4 < SIZE * sizeof(uint64_t));
+        for (size_t i = 0; i < SIZE; i += 37) {
+            assert(v[i] == plain[i]);
+        }
+        assert(v[SIZE - 1] == plain[SIZE - 1]);
+
+        const auto decoded = v.ToVector();
+        assert(decoded.Size() == SIZE);
+        assert(std::equal(decoded.begin(), decoded.end(), plain.begin()));
+    }
+    {
+        // Произвольные значения, включая крайние
+        PackedIntVector v;
+        Vector<uint64_t> plain;
+        uint64_t state = 42;
+        for (size_t i = 0; i < SIZE; ++i) {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            const uint64_t value = i % 100 == 0 ? UINT64_MAX : (i % 7 == 0 ? 0 : state);
+            v.PushBack(value);
+            plain.PushBack(value);
+        }
+        for (size_t i = 0; i < SIZE; ++i) {
+            assert(v[i] == plain[i]);
+        }
+        uint64_t block[PackedIntVector::kBlockSize];
+        v.DecodeBlock(3, block);
+        assert(block[5] == plain[3 * PackedIntVector::kBlockSize + 5]);
+
+        // Все варианты распаковки дают одинаковый результат
+        for (const simd::Isa isa : {simd::Isa::kBaseline, simd::Isa::kAvx2, simd::Isa::kAvx512}) {
+            if (!simd::Supports(isa)) {
+                continue;
+            }
+            for (size_t index = 0; index < v.BlockCount(); ++index) {
+                v.DecodeBlock(index, block, isa);
+                assert(std::equal(block, block + PackedIntVector::kBlockSize,
+                                  plain.begin() + index * PackedIntVector::kBlockSize));
+            }
+        }
+    }
+    {
+        // Ширина разностей, при которой значения пересекают границы слов
+        PackedIntVector v;
+        Vector<uint64_t> plain;
+        for (size_t i = 0; i < PackedIntVector::kBlockSize * 3; ++i) {
+            const uint64_t value = i * 0x1'2345 + (i % 3) * 0x7'FFFF;
+            v.PushBack(value);
+            plain.PushBack(value);
+        }
+        for (size_t i = 0; i < plain.Size(); ++i) {
+            assert(v[i] == plain[i]);
+        }
+        uint64_t block[PackedIntVector::kBlockSize];
+        for (const simd::Isa isa : {simd::Isa::kBaseline, simd::Isa::kAvx2, simd::Isa::kAvx512}) {
+            if (!simd::Supports(isa)) {
+                continue;
+            }
+            v.DecodeBlock(2, block, isa);
+            assert(std::equal(block, block + PackedIntVector::kBlockSize,
+                              plain.begin() + 2 * PackedIntVector::kBlockSize));
+        }
+    }
+    {
+        PackedIntVector v;
+        for (size_t i = 0; i < PackedIntVector::kBlockSize * 2; ++i) {
+            v.PushBack(7);
+        }
+        assert(v.MemoryBytes() < 64);
+        assert(v[200] == 7);
+    }
+}
+
+void Test15() {
+    const size_t SIZE = 1000;
+    {
+        // Все конечные значения FP16 переживают преобразование туда и обратно
+        for (uint32_t bits = 0; bits <= 0xffff; ++bits) {
+            const auto half = static_cast<uint16_t>(bits);
+            if ((half & 0x7c00) == 0x7c00 && (half & 0x3ff) != 0) {
+                continue;
+            }
+            assert(Fp16Vector::Encode(Fp16Vector::Decode(half)) == half);
+        }
+        assert(Fp16Vector::Encode(1.0f) == 0x3c00);
+        assert(Fp16Vector::Encode(-2.0f) == 0xc000);
+        assert(Fp16Vector::Encode(65504.0f) == 0x7bff);
+        assert(Fp16Vector::Encode(65520.0f) == 0x7c00);
+        assert(Fp16Vector::Encode(1.0e-8f) == 0x0000);
+        assert(Fp16Vector::Decode(0x0001) == std::ldexp(1.0f, -24));
+        assert(std::isnan(Fp16Vector::Decode(Fp16Vector::Encode(std::nanf("")))));
+
+        assert(Bf16Vector::Encode(1.0f) == 0x3f80);
+        assert(Bf16Vector::Decode(0x3f80) == 1.0f);
+        assert(Bf16Vector::Decode(Bf16Vector::Encode(3.0e38f)) > 2.9e38f);
+        assert(std::isnan(Bf16Vector::Decode(Bf16Vector::Encode(std::nanf("")))));
+    }
+    {
+        Vector<float> values;
+        Vector<float> query;
+        for (size_t i = 0; i < SIZE; ++i) {
+            values.PushBack(static_cast<float>(i % 10) * 0.25f);
+            query.PushBack(1.0f - static_cast<float>(i % 4) * 0.5f);
+        }
+        float expected_dot = 0;
+        float expected_l2 = 0;
+        for (size_t i = 0; i < SIZE; ++i) {
+            expected_dot += values[i] * query[i];
+            expected_l2 += (values[i] - query[i]) * (values[i] - query[i]);
+        }
+
+        const Fp16Vector fp16(values);
+        const Bf16Vector bf16(values);
+        assert(fp16.Size() == SIZE);
+        assert(fp16[7] == 1.75f);
+        assert(bf16[7] == 1.75f);
+        assert(fp16.Dot(query) == expected_dot);
+        assert(bf16.Dot(query) == expected_dot);
+        assert(std::abs(fp16.L2Distance(query) - std::sqrt(expected_l2)) < 1e-3f);
+        assert(fp16.Dot(Fp16Vector(query)) == expected_dot);
+
+        Vector<float> decoded(SIZE);
+        fp16.DecodeTo(decoded);
+        assert(std::equal(decoded.begin(), decoded.end(), values.begin()));
+
+        Bf16Vector v;
+        v.PushBack(0.5f);
+        v.PushBack(-8.0f);
+        v.Set(0, 2.0f);
+        assert(v.Size() == 2 && v[0] == 2.0f && v[1] == -8.0f);
+        v.PopBack();
+        assert(v.Size() == 1);
+    }
+    for (simd::Isa isa : {simd::Isa::kBaseline, simd::Isa::kAvx2, simd::Isa::kAvx512}) {
+        if (!simd::Supports(isa)) {
+            continue;
+        }
+        // Пакетное преобразование совпадает с поэлементным при любой длине
+        Vector<uint16_t> all_halves;
+        for (uint32_t bits = 0; bits <= 0xffff; ++bits) {
+            all_halves.PushBack(static_cast<uint16_t>(bits));
+        }
+        Vector<float> all_floats;
+        for (size_t size : {size_t{13}, all_halves.Size()}) {
+            Fp16Vector halves;
+            for (size_t i = 0; i < size; ++i) {
+                halves.PushBack(Fp16Vector::Decode(all_halves[i]));
+            }
+            all_floats.Resize(size);
+            halves.DecodeTo(all_floats, isa);
+            Fp16Vector encoded;
+            encoded.EncodeFrom(all_floats, isa);
+            for (size_t i = 0; i < size; ++i) {
+                // NaN становится тихим, поэтому обратно получается тихий NaN
+                const float expected = Fp16Vector::Decode(all_halves[i]);
+                assert(std::memcmp(&all_floats[i], &expected, sizeof(float)) == 0);
+                assert(encoded.Data()[i] == (std::isnan(expected) ? all_halves[i] | 0x200 : all_halves[i]));
+            }
+        }
+
+        // Знак и старшие биты мантиссы NaN сохраняются при любом варианте
+        Vector<float> nans;
+        for (uint32_t bits : {0x7fffffffu, 0x7f800001u, 0xffc00000u, 0x7fa00000u, 0xff800100u, 0x7f802000u}) {
+            nans.PushBack(detail::BitsToFloat(bits));
+        }
+        Fp16Vector encoded_nans;
+        encoded_nans.EncodeFrom(nans, isa);
+        const uint16_t expected_nans[] = {0x7fff, 0x7e00, 0xfe00, 0x7f00, 0xfe00, 0x7e01};
+        for (size_t i = 0; i < nans.Size(); ++i) {
+            assert(encoded_nans.Data()[i] == expected_nans[i]);
+            assert(Fp16Vector::Encode(nans[i]) == expected_nans[i]);
+        }
+        Bf16Vector bf16_nans;
+        bf16_nans.EncodeFrom(nans, isa);
+        Vector<float> decoded_nans(nans.Size());
+        bf16_nans.DecodeTo(decoded_nans, isa);
+        for (size_t i = 0; i < nans.Size(); ++i) {
+            assert(bf16_nans.Data()[i] == Bf16Vector::Encode(nans[i]));
+            assert(std::isnan(decoded_nans[i]));
+        }
+        Vector<float> rounded;
+        for (float value : {65504.0f, 65520.0f, 1.0e-8f, -3.0e-5f, 1.0f + 1.0f / 4096, 1.0f + 3.0f / 4096, 1.0e6f}) {
+            rounded.PushBack(value);
+        }
+        Fp16Vector encoded;
+        encoded.EncodeFrom(rounded, isa);
+        for (size_t i = 0; i < rounded.Size(); ++i) {
+            assert(encoded.Data()[i] == Fp16Vector::Encode(rounded[i]));
+        }
+
+        Vector<float> values;
+        Vector<float> query;
+        for (size_t i = 0; i < SIZE + 5; ++i) {
+            values.PushBack(static_cast<float>(i % 10) * 0.25f);
+            query.PushBack(1.0f - static_cast<float>(i % 4) * 0.5f);
+        }
+        const Fp16Vector fp16(values);
+        const Fp16Vector fp16_query(query);
+        const Bf16Vector bf16(values);
+        assert(fp16.Dot(query, isa) == fp16.Dot(query, simd::Isa::kBaseline));
+        assert(fp16.Dot(fp16_query, isa) == fp16.Dot(query, simd::Isa::kBaseline));
+        assert(bf16.Dot(query, isa) == fp16.Dot(query, simd::Isa::kBaseline));
+        assert(fp16.L2Distance(query, isa) == fp16.L2Distance(query, simd::Isa::kBaseline));
+
+        // Произвольные значения: суммы копятся в тех же полосах, поэтому
+        // результаты вариантов расходятся не больше чем на округление FMA
+        Vector<float> noise;
+        Vector<float> noise_query;
+        uint32_t state = 7;
+        for (size_t i = 0; i < SIZE + 37; ++i) {
+            state = state * 1664525u + 1013904223u;
+            noise.PushBack(static_cast<float>(state >> 8) / (1 << 24) - 0.5f);
+            noise_query.PushBack(static_cast<float>(state >> 16 & 0xff) / 64 - 2.0f);
+        }
+        const auto close = [](float lhs, float rhs) {
+            return std::abs(lhs - rhs) <= 1e-4f * (1.0f + std::abs(rhs));
+        };
+        const Fp16Vector fp16_noise(noise);
+        const Bf16Vector bf16_noise(noise);
+        const Bf16Vector bf16_noise_query(noise_query);
+        assert(close(fp16_noise.Dot(noise_query, isa), fp16_noise.Dot(noise_query, simd::Isa::kBaseline)));
+        assert(close(fp16_noise.L2Distance(noise_query, isa),
+                     fp16_noise.L2Distance(noise_query, simd::Isa::kBaseline)));
+        assert(close(bf16_noise.Dot(noise_query, isa), bf16_noise.Dot(noise_query, simd::Isa::kBaseline)));
+        assert(close(bf16_noise.Dot(bf16_noise_query, isa),
+                     bf16_noise.Dot(bf16_noise_query, simd::Isa::kBaseline)));
+        double expected = 0;
+        for (size_t i = 0; i < noise.Size(); ++i) {
+            expected += static_cast<double>(bf16_noise[i]) * bf16_noise_query[i];
+        }
+        assert(close(bf16_noise.Dot(bf16_noise_query, isa), static_cast<float>(expected)));
+    }
+}
+
+void Test16() {
+    const int SIZE = 100;
+    using namespace std::literals;
+    {
+        SlotMap<std::string> entities;
+        Vector<SlotMap<std::string>::Handle> handles;
+        for (int i = 0; i < SIZE; ++i) {
+            handles.PushBack(entities.Insert(std::to_string(i)));
+        }
+        assert(entities.Size() == SIZE);
+        assert(entities[handles[42]] == "42"s);
+
+        // Удаление не влияет на остальные дескрипторы
+        for (int i = 0; i < SIZE; i += 2) {
+            assert(entities.Erase(handles[i]));
+        }
+        assert(entities.Size() == SIZE / 2);
+        for (int i = 0; i < SIZE; ++i) {
+            if (i % 2 == 0) {
+                assert(!entities.Contains(handles[i]));
+                assert(entities.Find(handles[i]) == nullptr);
+            } else {
+                assert(*entities.Find(handles[i]) == std::to_string(i));
+            }
+        }
+        assert(!entities.Erase(handles[0]));
+
+        // Освобождённые слоты переиспользуются с новым поколением
+        const auto reused = entities.Insert("new"s);
+        assert(reused.index == handles[SIZE - 2].index);
+        assert(reused != handles[SIZE - 2]);
+        assert(!entities.Contains(handles[SIZE - 2]));
+        assert(entities[reused] == "new"s);
+
+        size_t visited = 0;
+        for (const auto& value : entities) {
+            assert(!value.empty());
+            ++visited;
+        }
+        assert(visited == entities.Size());
+        for (size_t i = 0; i < entities.Size(); ++i) {
+            assert(&entities[entities.HandleAt(i)] == &*(entities.begin() + i));
+        }
+    }
+    {
+        Obj::ResetCounters();
+        {
+            SlotMap<Obj> objects;
+            const auto first = objects.Emplace(1);
+            const auto second = objects.Emplace(2);
+            objects.Erase(first);
+            assert(objects[second].id == 2);
+            assert(Obj::GetAliveObjectCount() == 1);
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+}
+
+void Test17() {
+    const int SIZE = 1000;
+    {
+        Hive<int> hive;
+        assert(hive.begin() == hive.end());
+        Vector<int*> pointers;
+        for (int i = 0; i < SIZE; ++i) {
+            pointers.PushBack(&*hive.Insert(i));
+        }
+        assert(hive.Size() == SIZE);
+        const size_t capacity = hive.Capacity();
+        const size_t blocks = hive.BlockCount();
+
+        // Удаляем каждый элемент, кроме кратных 3, серии дыр сливаются
+        for (auto it = hive.begin(); it != hive.end();) {
+            it = *it % 3 == 0 ? std::next(it) : hive.Erase(it);
+        }
+        assert(hive.Size() == (SIZE + 2) / 3);
+        int expected = 0;
+        for (const int value : hive) {
+            assert(value == expected);
+            expected += 3;
+        }
+        assert(expected == SIZE + 2);
+        // Указатели на оставшиеся элементы не изменились
+        for (int i = 0; i < SIZE; i += 3) {
+            assert(*pointers[i] == i);
+        }
+
+        // Новые элементы занимают дыры, а не новые блоки
+        for (int i = 0; i < SIZE - (SIZE + 2) / 3; ++i) {
+            hive.Insert(-1);
+        }
+        assert(hive.Size() == SIZE);
+        assert(hive.Capacity() == capacity);
+        assert(hive.BlockCount() == blocks);
+        size_t count = 0;
+        int sum = 0;
+        for (const int value : hive) {
+            ++count;
+            sum += value;
+        }
+        assert(count == SIZE);
+        int expected_sum = 0;
+        for (int i = 0; i < SIZE; i += 3) {
+            expected_sum += i - 1;
+        }
+        assert(sum == expected_sum - (SIZE - 2 * ((SIZE + 2) / 3)));
+
+        // Удаление всех элементов
+        for (auto it = hive.begin(); it != hive.end();) {
+            it = hive.Erase(it);
+        }
+        assert(hive.Size() == 0);
+        assert(hive.begin() == hive.end());
+    }
+    {
+        // Удаление в обратном порядке сливает дыры в одну серию на блок
+        Hive<int> hive;
+        Vector<Hive<int>::iterator> positions;
+        for (int i = 0; i < SIZE; ++i) {
+            positions.PushBack(hive.Insert(i));
+        }
+        for (size_t i = positions.Size(); i-- > 0;) {
+            if (i % 100 != 0) {
+                hive.Erase(positions[i]);
+            }
+        }
+        assert(hive.Size() == SIZE / 100);
+        assert(hive.FreeRunCount() <= hive.BlockCount() + SIZE / 100);
+        int expected = 0;
+        for (const int value : hive) {
+            assert(value == expected);
+            expected += 100;
+        }
+
+        // Под нагрузкой вставок и удалений на каждую серию одна запись
+        Hive<int> churn;
+        Vector<Hive<int>::iterator> items;
+        for (int i = 0; i < 9; ++i) {
+            items.PushBack(churn.Insert(i));
+        }
+        const size_t churn_capacity = churn.Capacity();
+        for (int i = 0; i < 100000; ++i) {
+            const size_t position = static_cast<size_t>(i * 7919) % items.Size();
+            churn.Erase(items[position]);
+            items[position] = churn.Insert(i);
+            assert(churn.FreeRunCount() == 0);
+        }
+        churn.Erase(items[3]);
+        churn.Erase(items[5]);
+        churn.Erase(items[4]);
+        assert(churn.FreeRunCount() == 1 && churn.Size() == 6);
+        churn.Insert(-1);
+        assert(churn.FreeRunCount() == 1);
+        churn.Insert(-2);
+        churn.Insert(-3);
+        assert(churn.FreeRunCount() == 0 && churn.Size() == 9 && churn.Capacity() == churn_capacity);
+    }
+    {
+        Obj::ResetCounters();
+        {
+            Hive<Obj> hive;
+            auto first = hive.Emplace(1);
+            hive.Emplace(2);
+            hive.Emplace(3);
+            hive.Erase(first);
+            assert(Obj::GetAliveObjectCount() == 2);
+            assert(hive.begin()->id == 2);
+            assert(Obj::num_moved == 0 && Obj::num_copied == 0);
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+}
+
+namespace {
+
+struct HeapEntry {
+    int priority;
+    size_t id;
+};
+
+struct HeapEntryGreater {
+    bool operator()(const HeapEntry& lhs, const HeapEntry& rhs) const noexcept {
+        return lhs.priority > rhs.priority;
+    }
+};
+
+struct HeapPositions {
+    void operator()(const HeapEntry& entry, size_t position) const {
+        (*positions)[entry.id] = position;
+    }
+    Vector<size_t>* positions;
+};
+
+}  // namespace
+
+void Test18() {
+    const int SIZE = 1000;
+    {
+        DaryHeap<int> heap;
+        assert(heap.Empty());
+        for (int i = 0; i < SIZE; ++i) {
+            heap.Push((i * 7919) % SIZE);
+        }
+        assert(heap.Size() == SIZE);
+        for (int expected = SIZE - 1; expected >= 0; --expected) {
+            assert(heap.Top() == expected);
+            heap.Pop();
+        }
+        assert(heap.Empty());
+    }
+    {
+        DaryHeap<int, 8, std::greater<int>> heap;
+        heap.Push(SIZE);
+        Vector<int> batch;
+        for (int i = 0; i < SIZE; ++i) {
+            batch.PushBack((i * 31) % SIZE);
+        }
+        heap.PushRange(batch);
+        heap.PushRange(Span<const int>(batch.begin(), 10));
+        assert(heap.Size() == SIZE + 11);
+        int previous = -1;
+        while (!heap.Empty()) {
+            assert(previous <= heap.Top());
+            previous = heap.Top();
+            heap.Pop();
+        }
+        assert(previous == SIZE);
+    }
+    {
+        // Уменьшение ключа по внешнему индексу позиций
+        Vector<size_t> positions(SIZE);
+        DaryHeap<HeapEntry, 4, HeapEntryGreater, HeapPositions> heap(HeapEntryGreater{},
+                                                                     HeapPositions{&positions});
+        for (size_t id = 0; id < SIZE; ++id) {
+            heap.Push(HeapEntry{static_cast<int>(SIZE + id), id});
+        }
+        for (size_t id = 0; id < SIZE; ++id) {
+            assert(heap.At(positions[id]).id == id);
+        }
+        heap.Replace(positions[SIZE - 1], HeapEntry{-1, SIZE - 1});
+        assert(heap.Top().id == SIZE - 1);
+        heap.Replace(positions[SIZE / 2], HeapEntry{-2, SIZE / 2});
+        assert(heap.Top().id == SIZE / 2);
+        heap.Erase(positions[SIZE / 2]);
+        assert(heap.Top().id == SIZE - 1);
+        heap.Pop();
+        for (int expected = SIZE; !heap.Empty(); ++expected) {
+            if (expected == SIZE + SIZE / 2) {
+                ++expected;
+            }
+            assert(heap.Top().priority == expected);
+            assert(positions[heap.Top().id] == 0);
+            heap.Pop();
+        }
+    }
+}
+
+namespace {
+
+// Копирование бросает после заданного числа удачных копий,
+// перенос не объявлен noexcept
+struct FragileValue {
+    explicit FragileValue(int id)
+        : id(id) {
+    }
+
+    FragileValue(const FragileValue& other)
+        : id(other.id) {
+        if (copies_left == 0) {
+            throw std::runtime_error("Oops");
+        }
+        --copies_left;
+    }
+
+    FragileValue(FragileValue&& other)
+        : id(other.id) {
+    }
+
+    FragileValue& operator=(const FragileValue&) = default;
+    FragileValue& operator=(FragileValue&&) = default;
+
+    bool operator<(const FragileValue& other) const noexcept {
+        return id < other.id;
+    }
+
+    int id;
+    static inline int copies_left = -1;
+};
+
+}  // namespace
+
+void Test19() {
+    const int SIZE = 1000;
+    using namespace std::literals;
+    {
+        FlatMap<int, std::string> map;
+        assert(map.Empty());
+        for (int i = 0; i < SIZE; i += 2) {
+            assert(map.Insert(i, std::to_string(i)));
+        }
+        assert(!map.Insert(10, "ten"s));
+        assert(*map.Find(10) == "10"s);
+        assert(map.Find(11) == nullptr);
+
+        Vector<std::pair<int, std::string>> batch;
+        for (int i = SIZE - 1; i >= 0; i -= 3) {
+            batch.PushBack({i, "batch"s});
+        }
+        batch.PushBack({1, "first"s});
+        batch.PushBack({1, "second"s});
+        map.InsertBatch(std::move(batch));
+        assert(std::is_sorted(map.Keys().begin(), map.Keys().end()));
+        assert(std::adjacent_find(map.Keys().begin(), map.Keys().end()) == map.Keys().end());
+        assert(*map.Find(0) == "0"s);
+        assert(*map.Find(SIZE - 1) == "batch"s);
+        assert(*map.Find(SIZE - 4) == "996"s);
+        assert(*map.Find(1) == "first"s);
+        assert(map.Keys().Size() == map.Values().Size());
+
+        size_t expected_size = 0;
+        for (int i = 0; i < SIZE; ++i) {
+            expected_size += i % 2 == 0 || (SIZE - 1 - i) % 3 == 0 || i == 1;
+        }
+        assert(map.Size() == expected_size);
+
+        map[SIZE] = "new"s;
+        assert(map.Contains(SIZE));
+        assert(map.Erase(SIZE));
+        assert(!map.Erase(SIZE));
+        assert(map.Size() == expected_size);
+    }
+    {
+        Vector<std::pair<std::string, int>> entries;
+        entries.PushBack({"b"s, 2});
+        entries.PushBack({"a"s, 1});
+        entries.PushBack({"c"s, 3});
+        entries.PushBack({"a"s, 10});
+        const auto map = FlatMap<std::string, int>::FromUnsorted(std::move(entries));
+        assert(map.Size() == 3);
+        assert(map.Keys()[0] == "a"s && map.Values()[0] == 1);
+        assert(*map.Find("c"s) == 3);
+    }
+    {
+        Vector<int> keys;
+        for (int i = 0; i < SIZE; ++i) {
+            keys.PushBack((i * 7) % 100);
+        }
+        auto set = FlatSet<int>::FromUnsorted(std::move(keys));
+        assert(set.Size() == 100);
+        assert(set.Contains(99) && !set.Contains(100));
+        assert(set.Insert(150) && !set.Insert(150));
+        Vector<int> batch;
+        batch.PushBack(200);
+        batch.PushBack(150);
+        batch.PushBack(-1);
+        batch.PushBack(200);
+        set.InsertBatch(std::move(batch));
+        assert(set.Size() == 103);
+        assert(set.Keys()[0] == -1);
+        assert(set.Keys()[102] == 200);
+        assert(set.Erase(-1) && !set.Contains(-1));
+    }
+    {
+        // Исключение при копировании значения не портит уже перенесённые ключи
+        FlatMap<std::string, FragileValue> map;
+        for (int i = 0; i < 10; ++i) {
+            map.Insert("k"s + std::to_string(i), FragileValue(i));
+        }
+        Vector<std::pair<std::string, FragileValue>> batch;
+        batch.Reserve(2);
+        batch.EmplaceBack("a"s, FragileValue(100));
+        batch.EmplaceBack("z"s, FragileValue(200));
+        FragileValue::copies_left = 3;
+        try {
+            map.InsertBatch(std::move(batch));
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        FragileValue::copies_left = -1;
+        assert(map.Size() == 10 && !map.Contains("a"s));
+        for (int i = 0; i < 10; ++i) {
+            assert(map.Find("k"s + std::to_string(i))->id == i);
+        }
+
+        FlatSet<FragileValue> set;
+        for (int i = 0; i < 10; ++i) {
+            set.Insert(FragileValue(i * 2));
+        }
+        Vector<FragileValue> keys;
+        keys.Reserve(2);
+        keys.EmplaceBack(-1);
+        keys.EmplaceBack(7);
+        FragileValue::copies_left = 4;
+        try {
+            set.InsertBatch(std::move(keys));
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        FragileValue::copies_left = -1;
+        assert(set.Size() == 10);
+        for (int i = 0; i < 10; ++i) {
+            assert(set.Keys()[i].id == i * 2);
+        }
+    }
+}
+
+namespace {
+
+struct StringHash {
+    using is_transparent = void;
+
+    size_t operator()(std::string_view value) const noexcept {
+        return std::hash<std::string_view>{}(value);
+    }
+};
+
+struct StringEqual {
+    using is_transparent = void;
+
+    bool operator()(std::string_view lhs, std::string_view rhs) const noexcept {
+        return lhs == rhs;
+    }
+};
+
+}  // namespace
+
+void Test20() {
+    const int SIZE = 10000;
+    using namespace std::literals;
+    {
+        FlatHashMap<int, std::string> map;
+        assert(map.Empty() && map.Find(1) == nullptr);
+        for (int i = 0; i < SIZE; ++i) {
+            assert(map.Insert(i, std::to_string(i)));
+        }
+        assert(!map.Insert(5, "five"s));
+        assert(map.Size() == SIZE);
+        assert(map.Size() <= map.Capacity());
+        for (int i = 0; i < SIZE; i += 2) {
+            assert(map.Erase(i));
+        }
+        assert(!map.Erase(0));
+        assert(map.Size() == SIZE / 2);
+        for (int i = 0; i < SIZE; ++i) {
+            const std::string* value = map.Find(i);
+            assert((value != nullptr) == (i % 2 == 1));
+            assert(value == nullptr || *value == std::to_string(i));
+        }
+
+        // Повторные вставки и удаления переиспользуют удалённые слоты
+        const size_t capacity = map.Capacity();
+        for (int round = 0; round < 10; ++round) {
+            for (int i = 0; i < SIZE; i += 2) {
+                map[i] = "even"s;
+            }
+            for (int i = 0; i < SIZE; i += 2) {
+                assert(map.Erase(i));
+            }
+        }
+        assert(map.Capacity() == capacity);
+
+        auto copy = map;
+        map.Clear();
+        assert(map.Empty() && !map.Contains(1));
+        assert(copy.Size() == SIZE / 2 && *copy.Find(SIZE - 1) == std::to_string(SIZE - 1));
+        size_t sum = 0;
+        copy.ForEach([&sum](const std::pair<int, std::string>& entry) {
+            sum += entry.first;
+        });
+        assert(sum == static_cast<size_t>(SIZE / 2) * (SIZE / 2));
+    }
+    {
+        FlatHashSet<std::string, StringHash, StringEqual> set;
+        set.Reserve(100);
+        const size_t capacity = set.Capacity();
+        for (int i = 0; i < 100; ++i) {
+            assert(set.Insert("key"s + std::to_string(i)));
+        }
+        assert(set.Capacity() == capacity);
+        assert(!set.Insert("key7"s));
+        assert(set.Contains("key42"sv));
+        assert(!set.Contains("key100"sv));
+        assert(set.Erase("key42"sv) && !set.Contains("key42"sv));
+        assert(set.Size() == 99);
+    }
+}
+
+void Test21() {
+    using namespace std::literals;
+    {
+        LruCache<int, std::string> cache(3);
+        assert(cache.Capacity() == 3 && cache.Size() == 0);
+        assert(cache.Put(1, "one"s));
+        assert(cache.Put(2, "two"s));
+        assert(cache.Put(3, "three"s));
+        assert(*cache.Get(1) == "one"s);
+        assert(cache.Put(4, "four"s));
+        // 2 - самая старая запись после обращения к 1
+        assert(!cache.Contains(2));
+        assert(cache.Get(2) == nullptr);
+        assert(cache.Size() == 3);
+        assert(!cache.Put(3, "THREE"s));
+        assert(*cache.Peek(3) == "THREE"s);
+
+        Vector<int> order;
+        cache.ForEach([&order](int key, const std::string&) {
+            order.PushBack(key);
+        });
+        assert(order.Size() == 3 && order[0] == 3 && order[1] == 4 && order[2] == 1);
+
+        assert(cache.Erase(4) && !cache.Erase(4));
+        assert(cache.Put(5, "five"s));
+        assert(cache.Contains(1) && cache.Contains(3) && cache.Contains(5));
+        assert(cache.GetStats().hits == 1);
+        assert(cache.GetStats().misses == 1);
+        assert(cache.GetStats().evictions == 1);
+    }
+    {
+        const size_t CAPACITY = 100;
+        LruCache<int, int> cache(CAPACITY);
+        for (int i = 0; i < 10000; ++i) {
+            cache.Put(i % 250, i);
+            if (i % 3 == 0) {
+                cache.Get((i * 7) % 250);
+            }
+            if (i % 11 == 0) {
+                cache.Erase((i * 13) % 250);
+            }
+        }
+        assert(cache.Capacity() == CAPACITY);
+        size_t count = 0;
+        cache.ForEach([&count, &cache](int key, int value) {
+            assert(value % 250 == key);
+            assert(cache.Peek(key) != nullptr && *cache.Peek(key) == value);
+            ++count;
+        });
+        assert(count == cache.Size() && count <= CAPACITY);
+        const auto& stats = cache.GetStats();
+        assert(stats.hits + stats.misses == 3334);
+        assert(stats.evictions > 0);
+        cache.ResetStats();
+        assert(cache.GetStats().hits == 0);
+    }
+    {
+        // Копия сохраняет ёмкость и порядок вытеснения
+        const LruCache<int, std::string> empty(4);
+        LruCache<int, std::string> empty_copy(empty);
+        assert(empty_copy.Capacity() == 4);
+        assert(empty_copy.Put(1, "one"s));
+
+        LruCache<int, std::string> cache(3);
+        cache.Put(1, "one"s);
+        cache.Put(2, "two"s);
+        cache.Put(3, "three"s);
+        cache.Erase(2);
+        cache.Get(1);
+        LruCache<int, std::string> copy(cache);
+        assert(copy.Capacity() == 3 && copy.Size() == 2);
+        assert(copy.Put(4, "four"s) && copy.Put(5, "five"s));
+        // 3 - самая старая запись копии
+        assert(!copy.Contains(3) && copy.Contains(1) && copy.Contains(4) && copy.Contains(5));
+        assert(cache.Contains(3) && !cache.Contains(4));
+
+        LruCache<int, std::string> assigned(1);
+        assigned = cache;
+        assert(assigned.Capacity() == 3 && *assigned.Peek(3) == "three"s);
+        LruCache<int, std::string> moved(std::move(assigned));
+        assert(moved.Capacity() == 3 && moved.Size() == 2);
+
+        // Исходный кеш после перемещения пуст, но пригоден к использованию
+        assert(assigned.Size() == 0 && assigned.Capacity() == 0);
+        assert(!assigned.Contains(1) && !assigned.Get(3) && !assigned.Peek(3) && !assigned.Erase(3));
+        assert(assigned.Put(7, "seven"s) && !assigned.Contains(7) && assigned.Size() == 0);
+        size_t visited = 0;
+        assigned.ForEach([&visited](int, const std::string&) {
+            ++visited;
+        });
+        assert(visited == 0);
+        assigned = moved;
+        assert(assigned.Size() == 2 && *assigned.Peek(3) == "three"s);
+        LruCache<int, std::string> reassigned(2);
+        reassigned = std::move(moved);
+        assert(!moved.Contains(3) && moved.Capacity() == 2);
+    }
+}
+
+template <size_t BlockSize>
+void CheckEytzingerIndex(const Vector<uint64_t>& sorted) {
+    const EytzingerIndex<uint64_t, BlockSize> index(sorted);
+    assert(index.Size() == sorted.Size());
+    const uint64_t max_key = sorted.Size() == 0 ? 0 : sorted[sorted.Size() - 1];
+    for (uint64_t key = 0; key <= max_key + 2; ++key) {
+        const size_t expected = std::lower_bound(sorted.begin(), sorted.end(), key) - sorted.begin();
+        assert(index.LowerBound(key) == expected);
+    }
+}
+
+void Test22() {
+    for (size_t size : {0, 1, 2, 3, 7, 8, 9, 15, 16, 17, 100, 1000}) {
+        Vector<uint64_t> sorted;
+        for (size_t i = 0; i < size; ++i) {
+            // Возрастающая последовательность с повторами и пропусками
+            sorted.PushBack(i / 3 * 5 + i % 2);
+        }
+        std::sort(sorted.begin(), sorted.end());
+        CheckEytzingerIndex<1>(sorted);
+        CheckEytzingerIndex<3>(sorted);
+        CheckEytzingerIndex<8>(sorted);
+    }
+}
+
+void Test23() {
+    const size_t SIZE = 100000;
+    Vector<uint64_t> keys;
+    uint64_t key = 1000;
+    for (size_t i = 0; i < SIZE; ++i) {
+        // Участки с разной плотностью, повторы и редкие скачки
+        key += i % 1000 < 500 ? 1 : (i % 7 == 0 ? 0 : 37);
+        if (i % 25000 == 0) {
+            key += 1000000;
+        }
+        keys.PushBack(key);
+    }
+    const uint64_t max_key = keys[SIZE - 1];
+
+    const LearnedIndex<uint64_t> empty(Span<const uint64_t>(), 16);
+    assert(empty.LowerBound(5) == 0);
+
+    size_t previous_segments = SIZE;
+    for (size_t epsilon : {4, 32, 256}) {
+        const LearnedIndex<uint64_t> index(keys, epsilon);
+        assert(index.Size() == SIZE && index.Epsilon() == epsilon);
+        assert(index.SegmentCount() > 0 && index.SegmentCount() <= previous_segments);
+        previous_segments = index.SegmentCount();
+        for (uint64_t query = 0; query <= max_key + 10; query += query < 2000000 ? 13 : 9973) {
+            const size_t expected = std::lower_bound(keys.begin(), keys.end(), query) - keys.begin();
+            assert(index.LowerBound(query) == expected);
+        }
+        for (size_t i = 0; i < SIZE; i += 17) {
+            assert(keys[index.LowerBound(keys[i])] == keys[i]);
+        }
+    }
+
+    const auto compact = LearnedIndex<uint64_t>::FromBudget(keys, 1024);
+    assert(compact.SizeBytes() <= 1024);
+    assert(compact.LowerBound(max_key) == SIZE - 1);
+    assert(compact.LowerBound(max_key + 1) == SIZE);
+
+    Vector<double> reals;
+    for (size_t i = 0; i < 1000; ++i) {
+        reals.PushBack(std::sqrt(static_cast<double>(i)));
+    }
+    const LearnedIndex<double> real_index(reals, 8);
+    for (size_t i = 0; i < 1000; ++i) {
+        assert(real_index.LowerBound(reals[i]) == i);
+        assert(real_index.LowerBound(reals[i] + 1e-9) == i + 1);
+    }
+}
+
+void Test24() {
+    const size_t SIZE = 5000;
+    Vector<int> sorted;
+    for (size_t i = 0; i < SIZE; ++i) {
+        sorted.PushBack(static_cast<int>(i / 2 * 3));
+    }
+    Vector<int> keys;
+    for (int key = -5; key < static_cast<int>(SIZE) * 2; key += 7) {
+        keys.PushBack(key);
+    }
+    {
+        Vector<size_t> positions(keys.Size());
+        LowerBoundBatch(sorted, keys, positions);
+        for (size_t i = 0; i < keys.Size(); ++i) {
+            assert(positions[i] == static_cast<size_t>(
+                std::lower_bound(sorted.begin(), sorted.end(), keys[i]) - sorted.begin()));
+        }
+        LowerBoundBatch(Span<const int>(), keys, positions);
+        assert(std::all_of(positions.begin(), positions.end(), [](size_t position) {
+            return position == 0;
+        }));
+    }
+    {
+        FlatHashMap<int, size_t> map;
+        FlatHashSet<int> set;
+        Vector<int*> empty_out(keys.Size());
+        for (size_t i = 0; i < SIZE; i += 3) {
+            map.Insert(sorted[i], i);
+            set.Insert(sorted[i]);
+        }
+        Vector<size_t*> values(keys.Size());
+        Vector<bool> found(keys.Size());
+        map.FindBatch(Span<const int>(keys), Span<size_t*>(values));
+        set.ContainsBatch(Span<const int>(keys), Span<bool>(found));
+        for (size_t i = 0; i < keys.Size(); ++i) {
+            assert(values[i] == map.Find(keys[i]));
+            assert(found[i] == set.Contains(keys[i]));
+        }
+        FlatHashMap<int, int>().FindBatch(Span<const int>(keys), Span<int*>(empty_out));
+        assert(std::all_of(empty_out.begin(), empty_out.end(), [](int* value) {
+            return value == nullptr;
+        }));
+    }
+    {
+        Vector<size_t> indices;
+        for (size_t i = 0; i < SIZE; ++i) {
+            indices.PushBack((i * 7919) % SIZE);
+        }
+        Vector<int> gathered(SIZE);
+        Gather(sorted, indices, gathered);
+        for (size_t i = 0; i < SIZE; ++i) {
+            assert(gathered[i] == sorted[indices[i]]);
+        }
+    }
+}
+
+void Test25() {
+    const size_t SIZE = 1000;
+    Vector<int64_t> values;
+    for (size_t i = 0; i < SIZE; ++i) {
+        values.PushBack(static_cast<int64_t>(i % 10));
+    }
+    auto check = [&values](const PrefixSumVector<int64_t>& sums) {
+        assert(sums.Size() == values.Size());
+        int64_t expected = 0;
+        for (size_t i = 0; i < values.Size(); ++i) {
+            expected += values[i];
+            assert(sums[i] == values[i]);
+            assert(sums.PrefixSum(i) == expected);
+        }
+        assert(sums.Total() == expected);
+    };
+
+    PrefixSumVector<int64_t> sums(values);
+    check(sums);
+    for (size_t i = 0; i < SIZE; i += 7) {
+        sums.Add(i, 5);
+        values[i] += 5;
+    }
+    sums.Set(3, -100);
+    values[3] = -100;
+    check(sums);
+    assert(sums.RangeSum(10, 20) == 45 + 5);
+    assert(sums.RangeSum(20, 20) == 0);
+
+    for (int64_t i = 0; i < 50; ++i) {
+        sums.PushBack(i);
+        values.PushBack(i);
+    }
+    sums.PopBack();
+    values.PopBack();
+    check(sums);
+
+    Vector<int64_t> batch(SIZE);
+    std::fill(batch.begin(), batch.end(), 2);
+    sums.Append(batch);
+    for (int64_t value : batch) {
+        values.PushBack(value);
+    }
+    check(sums);
+    sums.Resize(SIZE / 2);
+    values.Resize(SIZE / 2);
+    check(sums);
+    sums.Resize(SIZE);
+    values.Resize(SIZE);
+    check(sums);
+
+    // Выборка по весам: элемент i занимает полуинтервал [PrefixSum(i - 1), PrefixSum(i))
+    PrefixSumVector<int> weights(5);
+    weights.Set(1, 3);
+    weights.Set(3, 2);
+    assert(weights.Search(0) == 1 && weights.Search(2) == 1);
+    assert(weights.Search(3) == 3 && weights.Search(4) == 3);
+    assert(weights.Search(5) == 5);
+    assert(PrefixSumVector<int>().Search(0) == 0);
+}
+
+namespace {
+
+// Ассоциативная, но не коммутативная операция: свёртка даёт самый старый отсчёт
+struct KeepFirst {
+    int operator()(int lhs, int) const noexcept {
+        return lhs;
+    }
+};
+
+struct Concat {
+    std::string operator()(const std::string& lhs, const std::string& rhs) const {
+        return lhs + rhs;
+    }
+};
+
+// Значение без операций сравнения и вычитания
+struct Word {
+    std::string text;
+};
+
+struct JoinWords {
+    Word operator()(const Word& lhs, const Word& rhs) const {
+        return Word{lhs.text + " " + rhs.text};
+    }
+};
+
+}  // namespace
+
+void Test26() {
+    const size_t WINDOW = 50;
+    Vector<int> samples;
+    for (int i = 0; i < 2000; ++i) {
+        samples.PushBack((i * 7919) % 1009 - 500);
+    }
+    {
+        auto window = WindowAggregator<int64_t>::ByCount(WINDOW);
+        auto first = WindowAggregator<int, KeepFirst>::ByCount(WINDOW);
+        auto bits = WindowAggregator<int, std::bit_or<int>>::ByCount(WINDOW);
+        for (size_t i = 0; i < samples.Size(); ++i) {
+            window.Push(samples[i]);
+            first.Push(samples[i]);
+            bits.Push(samples[i] & 0xff);
+            const size_t begin = i + 1 > WINDOW ? i + 1 - WINDOW : 0;
+            int64_t sum = 0;
+            int bit_or = 0;
+            for (size_t j = begin; j <= i; ++j) {
+                sum += samples[j];
+                bit_or |= samples[j] & 0xff;
+            }
+            assert(window.Size() == i + 1 - begin);
+            assert(window.Min() == *std::min_element(samples.begin() + begin, samples.begin() + i + 1));
+            assert(window.Max() == *std::max_element(samples.begin() + begin, samples.begin() + i + 1));
+            assert(window.Sum() == sum);
+            assert(window.Fold() == sum);
+            assert(first.Fold() == samples[begin]);
+            assert(bits.Fold() == bit_or);
+        }
+    }
+    {
+        // Окно длительностью 10: отсчёты с отметками в (now - 10, now]
+        auto window = WindowAggregator<int>::ByDuration(10);
+        for (int t = 0; t < 100; ++t) {
+            window.Push(t % 13, t * 3);
+            const int oldest = std::max(0, t - 3);
+            assert(window.Size() == static_cast<size_t>(t - oldest + 1));
+            int min = 100;
+            for (int j = oldest; j <= t; ++j) {
+                min = std::min(min, j % 13);
+            }
+            assert(window.Min() == min);
+        }
+        window.Advance(1000);
+        assert(window.Empty() && window.Sum() == 0);
+        window.Push(7, 1001);
+        assert(window.Min() == 7 && window.Max() == 7 && window.Fold() == 7);
+    }
+    {
+        // Нечисловые отсчёты: у строки нет -=, поэтому суммы нет
+        using namespace std::literals;
+        auto letters = WindowAggregator<std::string, Concat>::ByCount(3);
+        for (const char* letter : {"a", "b", "c", "d", "e"}) {
+            letters.Push(letter);
+        }
+        assert(letters.Fold() == "cde"s);
+        assert(letters.Min() == "c"s && letters.Max() == "e"s);
+
+        auto words = WindowAggregator<Word, JoinWords>::ByCount(2);
+        words.Push(Word{"one"s});
+        words.Push(Word{"two"s});
+        words.Push(Word{"three"s});
+        assert(words.Fold().text == "two three"s);
+    }
+    {
+        // Большой вытесненный отсчёт не оставляет ошибку в сумме
+        auto window = WindowAggregator<double>::ByCount(2);
+        window.Push(1e16);
+        window.Push(1.0);
+        window.Push(1.0);
+        assert(window.Sum() == 2.0 && window.Fold() == 2.0);
+    }
+}
+
+template <typename T>
+void CheckSimdKernels(const Vector<T>& values, T absent, simd::Isa isa) {
+    for (size_t i = 0; i < values.Size(); i += 5) {
+        const T value = values[i];
+        const size_t expected = std::find(values.begin(), values.end(), value) - values.begin();
+        assert(simd::Find<T>(values, value, isa) == expected);
+        assert(simd::Contains<T>(values, value, isa));
+        assert(simd::Count<T>(values, value, isa) ==
+               static_cast<size_t>(std::count(values.begin(), values.end(), value)));
+    }
+    assert(simd::Find<T>(values, absent, isa) == values.Size());
+    assert(!simd::Contains<T>(values, absent, isa));
+    assert(simd::Count<T>(values, absent, isa) == 0);
+
+    if (values.Size() > 0) {
+        const auto [min, max] = simd::MinMax<T>(values, isa);
+        assert(min == *std::min_element(values.begin(), values.end()));
+        assert(max == *std::max_element(values.begin(), values.end()));
+    }
+    double sum = 0;
+    for (const T& value : values) {
+        sum += static_cast<double>(value);
+    }
+    assert(static_cast<double>(simd::Sum<T>(values, isa)) == sum);
+
+    Vector<T> copy = values;
+    assert(simd::Equal<T>(values, copy, isa));
+    if (copy.Size() > 0) {
+        copy[copy.Size() - 1] = absent;
+        assert(!simd::Equal<T>(values, copy, isa));
+        copy.PopBack();
+        assert(!simd::Equal<T>(values, copy, isa));
+    }
+    simd::Fill<T>(copy, T(3), isa);
+    assert(static_cast<size_t>(std::count(copy.begin(), copy.end(), T(3))) == copy.Size());
+}
+
+void Test27() {
+    for (size_t size : {0, 1, 7, 8, 15, 16, 17, 63, 64, 65, 1000}) {
+        Vector<int32_t> ints;
+        Vector<uint8_t> bytes;
+        Vector<float> floats;
+        Vector<int64_t> longs;
+        for (size_t i = 0; i < size; ++i) {
+            ints.PushBack(static_cast<int32_t>((i * 7919) % 211) - 100);
+            bytes.PushBack(static_cast<uint8_t>(i * 31 % 251));
+            floats.PushBack(static_cast<float>((i * 37) % 101) * 0.5f);
+            longs.PushBack(static_cast<int64_t>(i * i) << 20);
+        }
+        // Каждый доступный вариант сверяется со скалярным результатом
+        for (simd::Isa isa : {simd::Isa::kBaseline, simd::Isa::kAvx2, simd::Isa::kAvx512}) {
+            if (!simd::Supports(isa)) {
+                continue;
+            }
+            CheckSimdKernels<int32_t>(ints, -101, isa);
+            CheckSimdKernels<uint8_t>(bytes, 255, isa);
+            CheckSimdKernels<float>(floats, -1.0f, isa);
+            CheckSimdKernels<int64_t>(longs, -1, isa);
+        }
+    }
+    // Сумма int32_t не переполняется: накопление идёт в int64_t
+    Vector<int32_t> large(100);
+    simd::Fill(large, INT32_MAX);
+    assert(simd::Sum(large) == int64_t{INT32_MAX} * 100);
+
+    // Тип элементов выводится из Vector, значение приводится к нему
+    Vector<uint8_t> bytes(40);
+    simd::Fill(bytes, 7);
+    bytes[33] = 3;
+    assert(simd::Find(bytes, 3) == 33 && simd::Contains(bytes, 7) && simd::Count(bytes, 7) == 39);
+    assert(simd::MinMax(bytes) == std::make_pair(uint8_t{3}, uint8_t{7}));
+    assert(simd::Sum(bytes) == 7 * 39 + 3);
+    assert(simd::Equal(bytes, bytes) && !simd::Equal(bytes, Span<const uint8_t>(bytes.begin(), 39)));
+
+    // На процессоре с AVX2 ядра выполняются не в базовом варианте
+    assert(simd::Supports(simd::BestIsa()));
+    assert(!simd::Supports(simd::Isa::kAvx2) || simd::BestIsa() != simd::Isa::kBaseline);
+    assert(!simd::Supports(simd::Isa::kAvx512) || simd::BestIsa() == simd::Isa::kAvx512);
+}
+
+template <typename T>
+void CheckRadixSort(Vector<T> values) {
+    Vector<T> expected = values;
+    std::stable_sort(expected.begin(), expected.end());
+    Vector<size_t> order = RadixArgsort(values);
+    assert(std::equal(order.begin(), order.end(), RadixArgsort(Span<const T>(values)).begin()));
+    for (size_t i = 0; i < order.Size(); ++i) {
+        assert(values[order[i]] == expected[i]);
+        assert(i == 0 || values[order[i - 1]] != values[order[i]] || order[i - 1] < order[i]);
+    }
+    RadixSort(values);
+    assert(std::equal(values.begin(), values.end(), expected.begin(), expected.end()));
+}
+
+void Test28() {
+    for (size_t size : {0, 1, 2, 100, 5000}) {
+        Vector<uint32_t> u32;
+        Vector<int64_t> i64;
+        Vector<int8_t> i8;
+        Vector<float> f32;
+        Vector<double> f64;
+        for (size_t i = 0; i < size; ++i) {
+            const uint64_t x = i * 0x9E3779B97F4A7C15ULL;
+            u32.PushBack(static_cast<uint32_t>(x >> 32));
+            i64.PushBack(static_cast<int64_t>(x));
+            i8.PushBack(static_cast<int8_t>(x >> 56));
+            f32.PushBack(static_cast<float>(static_cast<int32_t>(x >> 40)) / 7.0f);
+            f64.PushBack(i % 3 == 0 ? -static_cast<double>(i % 17 + 1) : static_cast<double>(x % 1000) * 0.25);
+        }
+        CheckRadixSort(u32);
+        CheckRadixSort(i64);
+        CheckRadixSort(i8);
+        CheckRadixSort(f32);
+        CheckRadixSort(f64);
+    }
+    {
+        // Совпадающие старшие байты пропускаются, буфер переиспользуется
+        RawMemory<uint64_t> scratch;
+        for (int round = 0; round < 3; ++round) {
+            Vector<uint64_t> values;
+            for (uint64_t i = 0; i < 1000; ++i) {
+                values.PushBack((i * 7919 + round) % 1000);
+            }
+            RadixSort(values, scratch);
+            for (uint64_t i = 0; i < 1000; ++i) {
+                assert(values[i] == i);
+            }
+        }
+        assert(scratch.Capacity() == 1000);
+    }
+    {
+        Vector<int> keys;
+        Vector<uint16_t> ids;
+        for (int i = 0; i < 100; ++i) {
+            keys.PushBack(i % 10 - 5);
+            ids.PushBack(static_cast<uint16_t>(i));
+        }
+        const Vector<size_t> order = RadixArgsort(keys);
+        assert(order[0] == 0 && order[1] == 10 && order[99] == 99);
+        RadixSortByKey(keys, ids);
+        for (size_t i = 1; i < keys.Size(); ++i) {
+            assert(keys[i - 1] < keys[i] || (keys[i - 1] == keys[i] && ids[i - 1] < ids[i]));
+        }
+        assert(keys[0] == -5 && ids[0] == 0 && ids[1] == 10);
+    }
+}
+
+void Test29() {
+    using Item = std::pair<int, size_t>;
+    auto by_key = [](const Item& lhs, const Item& rhs) {
+        return lhs.first < rhs.first;
+    };
+    for (size_t k : {1, 2, 3, 5, 8, 13}) {
+        Vector<Vector<Item>> runs(k);
+        Vector<Item> expected;
+        for (size_t run = 0; run < k; ++run) {
+            // Последовательность 0 длинная и плотная, остальные - редкие,
+            // с повторами ключей между последовательностями
+            const size_t length = run == 0 ? 2000 : 50 + run * 10;
+            for (size_t i = 0; i < length; ++i) {
+                const int key = run == 0 ? static_cast<int>(i / 2) : static_cast<int>((i * 37 + run) % 1100);
+                runs[run].PushBack({key, run});
+            }
+            std::stable_sort(runs[run].begin(), runs[run].end(), by_key);
+            for (const Item& item : runs[run]) {
+                expected.PushBack(item);
+            }
+        }
+        std::stable_sort(expected.begin(), expected.end(), by_key);
+
+        Vector<const Vector<Item>*> pointers;
+        for (const Vector<Item>& run : runs) {
+            pointers.PushBack(&run);
+        }
+        Vector<Item> out;
+        out.PushBack({-1, SIZE_MAX});
+        MergeK(pointers, out, by_key);
+        assert(out.Size() == expected.Size() + 1);
+        assert(out.Capacity() == out.Size());
+        assert(std::equal(expected.begin(), expected.end(), out.begin() + 1));
+    }
+    {
+        Vector<int> a;
+        Vector<int> b;
+        Vector<int> empty;
+        for (int i = 0; i < 100; ++i) {
+            (i < 50 ? a : b).PushBack(i);
+        }
+        const Vector<int>* runs[] = {&b, &empty, &a};
+        Vector<int> out;
+        MergeK(Span<const Vector<int>* const>(runs, 3), out);
+        assert(out.Size() == 100 && std::is_sorted(out.begin(), out.end()));
+        MergeK(Span<const Vector<int>* const>(), out);
+        assert(out.Size() == 100);
+    }
+}
+
+void Test30() {
+    const size_t SIZE = 1000;
+    Vector<std::string> words;
+    Vector<int> keys;
+    for (size_t i = 0; i < SIZE; ++i) {
+        keys.PushBack(static_cast<int>((i * 7919) % 613));
+        words.PushBack(std::to_string(keys[i]));
+    }
+    {
+        // Применение результата сортировки индексов
+        const Vector<size_t> order = RadixArgsort<int>(keys);
+        Vector<int> sorted_keys = keys;
+        ApplyPermutation(sorted_keys, order);
+        ApplyPermutation(words, order);
+        assert(std::is_sorted(sorted_keys.begin(), sorted_keys.end()));
+        for (size_t i = 0; i < SIZE; ++i) {
+            assert(words[i] == std::to_string(sorted_keys[i]));
+        }
+    }
+    {
+        // Перестановка из циклов разной длины, включая неподвижные точки
+        Vector<size_t> permutation(SIZE);
+        for (size_t begin = 0, length = 1; begin < SIZE; begin += length, length = length % 7 + 1) {
+            const size_t cycle = std::min(length, SIZE - begin);
+            for (size_t i = 0; i < cycle; ++i) {
+                permutation[begin + i] = begin + (i + 1) % cycle;
+            }
+        }
+        Vector<size_t> values(SIZE);
+        for (size_t i = 0; i < SIZE; ++i) {
+            values[i] = i * 2;
+        }
+        ApplyPermutation(values, permutation);
+        for (size_t i = 0; i < SIZE; ++i) {
+            assert(values[i] == permutation[i] * 2);
+        }
+    }
+    {
+        Vector<uint32_t> indices;
+        for (size_t i = 0; i < SIZE; ++i) {
+            indices.PushBack(static_cast<uint32_t>((i * 7919) % SIZE));
+        }
+        const Vector<int> gathered = Gather(keys, indices);
+        assert(gathered.Size() == SIZE && gathered.Capacity() == SIZE);
+        const Vector<int> from_spans = Gather(Span<const int>(keys), Span<const uint32_t>(indices));
+        assert(std::equal(from_spans.begin(), from_spans.end(), gathered.begin()));
+        Vector<int> restored(SIZE);
+        Scatter(gathered, indices, restored);
+        for (size_t i = 0; i < SIZE; ++i) {
+            assert(gathered[i] == keys[indices[i]]);
+            assert(restored[i] == keys[i]);
+        }
+    }
+}
+
 int main() {
     try {
         Test1();
@@ -387,6 +2414,31 @@ int main() {
         Test3();
         Test4();
         Test5();
+        Test6();
+        Test7();
+        Test8();
+        Test9();
+        Test10();
+        Test11();
+        Test12();
+        Test13();
+        Test14();
+        Test15();
+        Test16();
+        Test17();
+        Test18();
+        Test19();
+        Test20();
+        Test21();
+        Test22();
+        Test23();
+        Test24();
+        Test25();
+        Test26();
+        Test27();
+        Test28();
+        Test29();
+        Test30();
     } catch (const std::exception& e) {
         std::cerr << e.what() << std::endl;
     }
@@ -0,0 +1,178 @@
+#pragma once
+
+#include "span.h"
+#include "vector.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <utility>
+
+namespace detail {
+
+// После стольких побед подряд одной последовательности включается
+// копирование блоком
+constexpr size_t kMergeGallopStreak = 4;
+
+// Дерево проигравших над k отсортированными последовательностями:
+// внутренний узел хранит номер проигравшей в его матче, tree_[0] -
+// общий победитель. После выдачи элемента переигрывается только путь
+// от листа победителя к корню, log2(k) сравнений. При равенстве
+// побеждает последовательность с меньшим номером, поэтому слияние устойчиво
+template <typename T, typename Compare>
+class LoserTree {
+public:
+    LoserTree(Span<const Vector<T>* const> runs, const Compare& compare)
+        : runs_(runs)
+        , compare_(compare)
+        , positions_(runs.Size())
+        , tree_(runs.Size()) {
+        const size_t k = runs.Size();
+        if (k == 1) {
+            tree_[0] = 0;
+            return;
+        }
+        // Победители поддеревьев нужны только при построении;
+        // листья имеют номера k..2k-1
+        Vector<size_t> winners(k);
+        for (size_t node = k; node-- > 1;) {
+            const size_t left = Child(2 * node, winners);
+            const size_t right = Child(2 * node + 1, winners);
+            const bool left_wins = Beats(left, right);
+            winners[node] = left_wins ? left : right;
+            tree_[node] = left_wins ? right : left;
+        }
+        tree_[0] = winners[1];
+    }
+
+    bool Done() const noexcept {
+        return Exhausted(tree_[0]);
+    }
+
+    size_t Winner() const noexcept {
+        return tree_[0];
+    }
+
+    const T& Current(size_t run) const noexcept {
+        return (*runs_[run])[positions_[run]];
+    }
+
+    size_t Position(size_t run) const noexcept {
+        return positions_[run];
+    }
+
+    // Сдвигает победителя на count элементов и переигрывает его путь
+    void Advance(size_t count) {
+        size_t winner = tree_[0];
+        positions_[winner] += count;
+        for (size_t node = (winner + runs_.Size()) / 2; node > 0; node /= 2) {
+            if (Beats(tree_[node], winner)) {
+                std::swap(tree_[node], winner);
+            }
+        }
+        tree_[0] = winner;
+    }
+
+    // Лучший соперник победителя: второй элемент проиграл победителю
+    // в одном из матчей на его пути. SIZE_MAX, если соперников не осталось
+    size_t RunnerUp() const {
+        size_t best = SIZE_MAX;
+        for (size_t node = (tree_[0] + runs_.Size()) / 2; node > 0; node /= 2) {
+            const size_t candidate = tree_[node];
+            if (!Exhausted(candidate) && (best == SIZE_MAX || Beats(candidate, best))) {
+                best = candidate;
+            }
+        }
+        return best;
+    }
+
+    // Элемент value последовательности run идёт раньше текущего элемента rival
+    bool Precedes(const T& value, size_t run, size_t rival) const {
+        const T& other = Current(rival);
+        return compare_(value, other) || (!compare_(other, value) && run < rival);
+    }
+
+private:
+    size_t Child(size_t node, const Vector<size_t>& winners) const noexcept {
+        return node >= runs_.Size() ? node - runs_.Size() : winners[node];
+    }
+
+    bool Exhausted(size_t run) const noexcept {
+        return positions_[run] == runs_[run]->Size();
+    }
+
+    bool Beats(size_t lhs, size_t rhs) const {
+        if (Exhausted(lhs) || Exhausted(rhs)) {
+            return !Exhausted(lhs) || (Exhausted(rhs) && lhs < rhs);
+        }
+        return Precedes(Current(lhs), lhs, rhs);
+    }
+
+    Span<const Vector<T>* const> runs_;
+    const Compare& compare_;
+    Vector<size_t> positions_;
+    Vector<size_t> tree_;
+};
+
+}  // namespace detail
+
+// Устойчиво сливает отсортированные по compare последовательности runs,
+// дописывая результат в конец out (out не должен быть среди runs).
+// Память под результат выделяется один раз. Если одна последовательность
+// выигрывает несколько раз подряд, её элементы до первого, уступающего
+// сопернику, находятся экспоненциальным поиском и копируются одним блоком.
+// Тип элементов выводится из out, поэтому runs можно передать как Vector
+template <typename T, typename Compare = std::less<T>>
+void MergeK(Span<const detail::NonDeduced<Vector<T>>* const> runs, Vector<T>& out, Compare compare = Compare()) {
+    size_t total = out.Size();
+    for (const Vector<T>* run : runs) {
+        total += run->Size();
+    }
+    out.Reserve(total);
+    if (runs.Size() == 0) {
+        return;
+    }
+
+    detail::LoserTree<T, Compare> tree(runs, compare);
+    size_t streak_run = SIZE_MAX;
+    size_t streak = 0;
+    while (!tree.Done()) {
+        const size_t winner = tree.Winner();
+        streak = winner == streak_run ? streak + 1 : 1;
+        streak_run = winner;
+        if (streak < detail::kMergeGallopStreak) {
+            out.PushBack(tree.Current(winner));
+            tree.Advance(1);
+            continue;
+        }
+
+        const Vector<T>& run = *runs[winner];
+        const size_t first = tree.Position(winner);
+        const size_t rival = tree.RunnerUp();
+        size_t last = run.Size();
+        if (rival != SIZE_MAX) {
+            // Граница между first + step / 2 и first + step
+            size_t low = first + 1;
+            size_t step = 1;
+            while (first + step < run.Size() && tree.Precedes(run[first + step], winner, rival)) {
+                low = first + step + 1;
+                step *= 2;
+            }
+            size_t high = std::min(first + step, run.Size());
+            while (low < high) {
+                const size_t middle = low + (high - low) / 2;
+                if (tree.Precedes(run[middle], winner, rival)) {
+                    low = middle + 1;
+                } else {
+                    high = middle;
+                }
+            }
+            last = low;
+        }
+        for (size_t i = first; i < last; ++i) {
+            out.PushBack(run[i]);
+        }
+        tree.Advance(last - first);
+        streak = 0;
+    }
+}
@@ -0,0 +1,201 @@
+#pragma once
+
+#include "bit_vector.h"
+#include "vector.h"
+
+#include <cassert>
+#include <cstdint>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+// Колонка значений с пропусками: плотные значения в Vector<T> и
+// битовая маска валидности. На месте пропуска хранится T{}
+template <typename T>
+class NullableVector {
+public:
+    NullableVector() = default;
+
+    size_t Size() const noexcept {
+        return values_.Size();
+    }
+
+    size_t NullCount() const noexcept {
+        return null_count_;
+    }
+
+    const T* Values() const noexcept {
+        return values_.begin();
+    }
+
+    const BitVector& Validity() const noexcept {
+        return validity_;
+    }
+
+    bool IsValid(size_t index) const noexcept {
+        return validity_[index];
+    }
+
+    std::optional<T> operator[](size_t index) const {
+        if (!IsValid(index)) {
+            return std::nullopt;
+        }
+        return values_[index];
+    }
+
+    void Reserve(size_t capacity) {
+        values_.Reserve(capacity);
+        validity_.Reserve(capacity);
+    }
+
+    void PushBack(const T& value) {
+        EmplaceBack(value);
+    }
+
+    void PushBack(T&& value) {
+        EmplaceBack(std::move(value));
+    }
+
+    // Принимает только std::optional<T>: с перегрузкой от std::optional<T>
+    // вызов PushBack("abc") для строк был бы неоднозначным
+    template <typename Optional,
+              typename = std::enable_if_t<std::is_same_v<std::decay_t<Optional>, std::optional<T>>>>
+    void PushBack(Optional&& value) {
+        if (value) {
+            EmplaceBack(*std::forward<Optional>(value));
+        } else {
+            PushNull();
+        }
+    }
+
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args) {
+        T& value = values_.EmplaceBack(std::forward<Args>(args)...);
+        try {
+            validity_.PushBack(true);
+        } catch (...) {
+            values_.PopBack();
+            throw;
+        }
+        return value;
+    }
+
+    void PushNull() {
+        values_.EmplaceBack();
+        try {
+            validity_.PushBack(false);
+        } catch (...) {
+            values_.PopBack();
+            throw;
+        }
+        ++null_count_;
+    }
+
+    void PopBack() noexcept {
+        if (!IsValid(Size() - 1)) {
+            --null_count_;
+        }
+        validity_.PopBack();
+        values_.PopBack();
+    }
+
+    void Set(size_t index, T value) {
+        values_[index] = std::move(value);
+        if (!IsValid(index)) {
+            validity_.Set(index);
+            --null_count_;
+        }
+    }
+
+    void SetNull(size_t index) {
+        if (IsValid(index)) {
+            values_[index] = T{};
+            validity_.Set(index, false);
+            ++null_count_;
+        }
+    }
+
+    // Вызывает func(index, value) для каждого непустого значения по порядку.
+    // Маска просматривается по словам: полностью заполненные и пустые слова
+    // обрабатываются без проверки отдельных битов
+    template <typename Func>
+    void ForEachValid(Func func) const {
+        const T* values = values_.begin();
+        if (null_count_ == 0) {
+            for (size_t i = 0, n = Size(); i < n; ++i) {
+                func(i, values[i]);
+            }
+            return;
+        }
+        const uint64_t* words = validity_.Words();
+        for (size_t w = 0, n = validity_.WordCount(); w < n; ++w) {
+            uint64_t word = words[w];
+            const size_t base = w * BitVector::kWordBits;
+            if (word == ~uint64_t{0}) {
+                for (size_t i = base; i < base + BitVector::kWordBits; ++i) {
+                    func(i, values[i]);
+                }
+                continue;
+            }
+            while (word != 0) {
+                const size_t i = base + detail::CountTrailingZeros(word);
+                func(i, values[i]);
+                word &= word - 1;
+            }
+        }
+    }
+
+    // Сумма в расширенном типе: int64_t, uint64_t или double, поэтому
+    // сумма многих малых целых не переполняет T
+    using SumType = std::conditional_t<std::is_floating_point_v<T>, double,
+                                       std::conditional_t<std::is_signed_v<T>, int64_t, uint64_t>>;
+
+    SumType Sum() const {
+        static_assert(std::is_arithmetic_v<T>, "Sum requires an arithmetic type");
+        SumType sum{};
+        ForEachValid([&sum](size_t, const T& value) {
+            sum += static_cast<SumType>(value);
+        });
+        return sum;
+    }
+
+    std::optional<T> Min() const {
+        return Extremum([](const T& lhs, const T& rhs) {
+            return lhs < rhs;
+        });
+    }
+
+    std::optional<T> Max() const {
+        return Extremum([](const T& lhs, const T& rhs) {
+            return rhs < lhs;
+        });
+    }
+
+    // Индексы непустых значений, для которых predicate вернул true
+    template <typename Predicate>
+    Vector<size_t> Filter(Predicate predicate) const {
+        Vector<size_t> indices;
+        ForEachValid([&indices, &predicate](size_t index, const T& value) {
+            if (predicate(value)) {
+                indices.PushBack(index);
+            }
+        });
+        return indices;
+    }
+
+private:
+    template <typename Less>
+    std::optional<T> Extremum(Less less) const {
+        std::optional<T> result;
+        ForEachValid([&result, &less](size_t, const T& value) {
+            if (!result || less(value, *result)) {
+                result = value;
+            }
+        });
+        return result;
+    }
+
+    Vector<T> values_;
+    BitVector validity_;
+    size_t null_count_ = 0;
+};
@@ -0,0 +1,276 @@
+#pragma once
+
+#include "vector.h"
+#include "vector_simd.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+
+#if VECTOR_SIMD_DISPATCH
+#include <immintrin.h>
+#endif
+
+namespace detail {
+
+inline uint64_t ZigZagDecode(uint64_t code) noexcept {
+    return (code >> 1) ^ (0 - (code & 1));
+}
+
+// Младшие width бит; width от 1 до 64
+inline uint64_t WidthMask(uint32_t width) noexcept {
+    return ~uint64_t{0} >> (64 - width);
+}
+
+// Значение с номером index всегда собирается из двух соседних слов:
+// сдвиг в два шага не бывает равен 64, а лишние биты отсекает маска
+inline uint64_t UnpackBits(const uint64_t* words, uint32_t width, uint64_t mask, size_t index) noexcept {
+    const size_t bit = index * width;
+    const size_t word = bit / 64;
+    const uint32_t offset = bit % 64;
+    const uint64_t low = words[word] >> offset;
+    const uint64_t high = (words[word + 1] << 1) << (63 - offset);
+    return (low | high) & mask;
+}
+
+inline void UnpackDeltasScalar(const uint64_t* words, uint32_t width, size_t begin, size_t end,
+                               uint64_t* out) noexcept {
+    const uint64_t mask = WidthMask(width);
+    for (size_t i = begin; i < end; ++i) {
+        out[i] = ZigZagDecode(UnpackBits(words, width, mask, i));
+    }
+}
+
+#if VECTOR_SIMD_DISPATCH
+// Те же шаги, что в UnpackBits, для нескольких значений сразу: слова
+// собираются gather-загрузкой, сдвиги у каждой полосы свои. Сдвиг
+// VPSLLVQ на 64 даёт ноль, поэтому второе слово сдвигается за один шаг.
+// Полоса читает слово за последним значением, поэтому векторный цикл
+// останавливается на полный регистр раньше конца
+__attribute__((target("avx2"))) inline size_t UnpackDeltasAvx2(const uint64_t* words, uint32_t width,
+                                                               size_t count, uint64_t* out) noexcept {
+    constexpr size_t kLanes = 4;
+    const auto* base = reinterpret_cast<const long long*>(words);
+    const __m256i mask = _mm256_set1_epi64x(static_cast<long long>(WidthMask(width)));
+    const __m256i one = _mm256_set1_epi64x(1);
+    const __m256i low_bits = _mm256_set1_epi64x(63);
+    const __m256i word_bits = _mm256_set1_epi64x(64);
+    const __m256i step = _mm256_set1_epi64x(static_cast<long long>(kLanes * width));
+    __m256i bits = _mm256_setr_epi64x(0, width, 2 * width, 3 * width);
+    size_t i = 0;
+    for (; i + kLanes < count; i += kLanes) {
+        const __m256i word = _mm256_srli_epi64(bits, 6);
+        const __m256i offset = _mm256_and_si256(bits, low_bits);
+        const __m256i low = _mm256_srlv_epi64(_mm256_i64gather_epi64(base, word, 8), offset);
+        const __m256i high = _mm256_sllv_epi64(_mm256_i64gather_epi64(base + 1, word, 8),
+                                               _mm256_sub_epi64(word_bits, offset));
+        const __m256i code = _mm256_and_si256(_mm256_or_si256(low, high), mask);
+        const __m256i sign = _mm256_sub_epi64(_mm256_setzero_si256(), _mm256_and_si256(code, one));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i),
+                            _mm256_xor_si256(_mm256_srli_epi64(code, 1), sign));
+        bits = _mm256_add_epi64(bits, step);
+    }
+    return i;
+}
+
+VECTOR_SIMD_AVX512_BEGIN
+__attribute__((target("avx512f"))) inline size_t UnpackDeltasAvx512(const uint64_t* words, uint32_t width,
+                                                                    size_t count, uint64_t* out) noexcept {
+    constexpr size_t kLanes = 8;
+    const auto* base = reinterpret_cast<const long long*>(words);
+    const __m512i mask = _mm512_set1_epi64(static_cast<long long>(WidthMask(width)));
+    const __m512i one = _mm512_set1_epi64(1);
+    const __m512i low_bits = _mm512_set1_epi64(63);
+    const __m512i word_bits = _mm512_set1_epi64(64);
+    const __m512i step = _mm512_set1_epi64(static_cast<long long>(kLanes * width));
+    __m512i bits = _mm512_mullox_epi64(_mm512_setr_epi64(0, 1, 2, 3, 4, 5, 6, 7), _mm512_set1_epi64(width));
+    size_t i = 0;
+    for (; i + kLanes < count; i += kLanes) {
+        const __m512i word = _mm512_srli_epi64(bits, 6);
+        const __m512i offset = _mm512_and_si512(bits, low_bits);
+        const __m512i low = _mm512_srlv_epi64(_mm512_i64gather_epi64(word, base, 8), offset);
+        const __m512i high = _mm512_sllv_epi64(_mm512_i64gather_epi64(word, base + 1, 8),
+                                               _mm512_sub_epi64(word_bits, offset));
+        const __m512i code = _mm512_and_si512(_mm512_or_si512(low, high), mask);
+        const __m512i sign = _mm512_sub_epi64(_mm512_setzero_si512(), _mm512_and_si512(code, one));
+        _mm512_storeu_si512(out + i, _mm512_xor_si512(_mm512_srli_epi64(code, 1), sign));
+        bits = _mm512_add_epi64(bits, step);
+    }
+    return i;
+}
+VECTOR_SIMD_AVX512_END
+#endif
+
+// Разности с номерами [0, count) в out; width от 1 до 64
+inline void UnpackDeltas(const uint64_t* words, uint32_t width, size_t count, uint64_t* out,
+                         simd::Isa isa) noexcept {
+    assert(simd::Supports(isa));
+    size_t done = 0;
+#if VECTOR_SIMD_DISPATCH
+    if (isa == simd::Isa::kAvx512) {
+        done = UnpackDeltasAvx512(words, width, count, out);
+    } else if (isa == simd::Isa::kAvx2) {
+        done = UnpackDeltasAvx2(words, width, count, out);
+    }
+#endif
+    UnpackDeltasScalar(words, width, done, count, out);
+}
+
+}  // namespace detail
+
+// Сжатый вектор 64-битных целых. Значения разбиты на блоки по kBlockSize:
+// блок хранит первое значение и разности соседних значений (zigzag),
+// упакованные минимальным числом бит. Для отсортированных идентификаторов
+// и меток времени разности малы. Незаполненный хвост хранится как есть.
+// За упакованными словами всегда есть ещё одно нулевое слово, поэтому
+// значение читается из двух соседних слов без проверки границы
+class PackedIntVector {
+public:
+    static constexpr size_t kBlockSize = 128;
+
+    PackedIntVector() = default;
+
+    size_t Size() const noexcept {
+        return blocks_.Size() * kBlockSize + tail_.Size();
+    }
+
+    // Объём сжатых данных в байтах
+    size_t MemoryBytes() const noexcept {
+        return blocks_.Size() * sizeof(Block) + words_.Size() * sizeof(uint64_t)
+             + tail_.Size() * sizeof(uint64_t);
+    }
+
+    void PushBack(uint64_t value) {
+        tail_.PushBack(value);
+        if (tail_.Size() == kBlockSize) {
+            Flush();
+        }
+    }
+
+    // Декодирует префикс блока до нужной позиции
+    uint64_t operator[](size_t index) const noexcept {
+        assert(index < Size());
+        const size_t block_index = index / kBlockSize;
+        if (block_index == blocks_.Size()) {
+            return tail_[index % kBlockSize];
+        }
+        const Block& block = blocks_[block_index];
+        uint64_t value = block.base;
+        if (block.width == 0) {
+            return value;
+        }
+        const uint64_t* words = words_.begin() + block.word_offset;
+        const uint64_t mask = detail::WidthMask(block.width);
+        for (size_t i = 0; i < index % kBlockSize; ++i) {
+            value += detail::ZigZagDecode(detail::UnpackBits(words, block.width, mask, i));
+        }
+        return value;
+    }
+
+    // Распаковывает блок целиком в out[0..kBlockSize). Разности распаковываются
+    // вариантом isa, префиксная сумма - последовательная
+    void DecodeBlock(size_t block_index, uint64_t* out, simd::Isa isa = simd::BestIsa()) const noexcept {
+        assert(block_index < blocks_.Size());
+        const Block& block = blocks_[block_index];
+        out[0] = block.base;
+        if (block.width == 0) {
+            std::fill(out + 1, out + kBlockSize, block.base);
+            return;
+        }
+        detail::UnpackDeltas(words_.begin() + block.word_offset, block.width, kBlockSize - 1, out + 1, isa);
+        for (size_t i = 1; i < kBlockSize; ++i) {
+            out[i] += out[i - 1];
+        }
+    }
+
+    size_t BlockCount() const noexcept {
+        return blocks_.Size();
+    }
+
+    // Последовательный проход: вызывает func(value) для всех значений по порядку
+    template <typename Func>
+    void ForEach(Func func) const {
+        uint64_t buffer[kBlockSize];
+        for (size_t block = 0; block < blocks_.Size(); ++block) {
+            DecodeBlock(block, buffer);
+            for (const uint64_t value : buffer) {
+                func(value);
+            }
+        }
+        for (const uint64_t value : tail_) {
+            func(value);
+        }
+    }
+
+    Vector<uint64_t> ToVector() const {
+        Vector<uint64_t> result;
+        result.Reserve(Size());
+        ForEach([&result](uint64_t value) {
+            result.PushBack(value);
+        });
+        return result;
+    }
+
+private:
+    // Первое значение блока хранится в base, упакованы только
+    // kBlockSize - 1 разностей
+    struct Block {
+        uint64_t base;
+        size_t word_offset;
+        uint32_t width;
+    };
+
+    static uint64_t ZigZagEncode(uint64_t delta) noexcept {
+        return (delta << 1) ^ (0 - (delta >> 63));
+    }
+
+    static uint32_t BitWidth(uint64_t value) noexcept {
+        uint32_t width = 0;
+        for (; value != 0; value >>= 1) {
+            ++width;
+        }
+        return width;
+    }
+
+    // Если значение не переходит в следующее слово, туда записывается ноль
+    static void Pack(uint64_t* words, uint32_t width, size_t index, uint64_t value) noexcept {
+        const size_t bit = index * width;
+        const size_t word = bit / 64;
+        const uint32_t offset = bit % 64;
+        words[word] |= value << offset;
+        words[word + 1] |= (value >> 1) >> (63 - offset);
+    }
+
+    void Flush() {
+        uint64_t codes[kBlockSize - 1];
+        uint64_t all_bits = 0;
+        for (size_t i = 0; i + 1 < kBlockSize; ++i) {
+            codes[i] = ZigZagEncode(tail_[i + 1] - tail_[i]);
+            all_bits |= codes[i];
+        }
+        const uint32_t width = BitWidth(all_bits);
+        const size_t word_count = ((kBlockSize - 1) * width + 63) / 64;
+        // Новый блок начинается на месте завершающего слова
+        const size_t word_offset = words_.Size() == 0 ? 0 : words_.Size() - 1;
+        const size_t new_size = word_offset + word_count + 1;
+
+        if (blocks_.Size() == blocks_.Capacity()) {
+            blocks_.Reserve(blocks_.Size() == 0 ? 1 : blocks_.Size() * 2);
+        }
+        if (new_size > words_.Capacity()) {
+            words_.Reserve(std::max(new_size, words_.Capacity() * 2));
+        }
+        words_.Resize(new_size);
+        if (width != 0) {
+            for (size_t i = 0; i + 1 < kBlockSize; ++i) {
+                Pack(words_.begin() + word_offset, width, i, codes[i]);
+            }
+        }
+        blocks_.PushBack(Block{tail_[0], word_offset, width});
+        tail_.Resize(0);
+    }
+
+    Vector<Block> blocks_;
+    Vector<uint64_t> words_;
+    Vector<uint64_t> tail_;
+};
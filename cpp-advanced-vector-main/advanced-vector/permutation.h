@@ -0,0 +1,37 @@
+#pragma once
+
+#include "bit_vector.h"
+#include "vector.h"
+
+#include <cassert>
+#include <utility>
+
+// Переставляет элементы на месте: после вызова values[i] равно прежнему
+// values[permutation[i]] (так применяется результат RadixArgsort).
+// Каждый цикл перестановки обходится один раз, пройденные позиции
+// отмечаются в битовой маске; дополнительная память - n бит и один элемент
+template <typename T, typename Index>
+void ApplyPermutation(Vector<T>& values, const Vector<Index>& permutation) {
+    assert(values.Size() == permutation.Size());
+    const size_t size = values.Size();
+    BitVector visited(size);
+    for (size_t start = 0; start < size; ++start) {
+        if (visited.Test(start)) {
+            continue;
+        }
+        T saved = std::move(values[start]);
+        size_t position = start;
+        while (true) {
+            visited.Set(position);
+            const size_t source = static_cast<size_t>(permutation[position]);
+            assert(source < size);
+            if (source == start) {
+                values[position] = std::move(saved);
+                break;
+            }
+            assert(!visited.Test(source));
+            values[position] = std::move(values[source]);
+            position = source;
+        }
+    }
+}
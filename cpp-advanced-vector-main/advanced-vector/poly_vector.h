@@ -0,0 +1,299 @@
+#pragma once
+
+#include "vector.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Вектор полиморфных объектов: наследники Base разного размера размещаются
+// подряд в одном байтовом буфере, доступ по индексу идёт через таблицу смещений
+template <typename Base>
+class PolyVector {
+    struct TypeOps {
+        void (*relocate)(unsigned char* from, unsigned char* to);
+        void (*destroy)(unsigned char* object) noexcept;
+    };
+
+    struct Entry {
+        size_t object_offset;
+        size_t base_offset;
+        const TypeOps* ops;
+    };
+
+public:
+    template <typename ValueType>
+    class BasicIterator {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = std::remove_const_t<ValueType>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = ValueType*;
+        using reference = ValueType&;
+
+        BasicIterator() = default;
+
+        BasicIterator(const Entry* entry, unsigned char* data) noexcept
+            : entry_(entry)
+            , data_(data) {
+        }
+
+        reference operator*() const noexcept {
+            return *reinterpret_cast<pointer>(data_ + entry_->base_offset);
+        }
+
+        pointer operator->() const noexcept {
+            return &**this;
+        }
+
+        reference operator[](difference_type n) const noexcept {
+            return *(*this + n);
+        }
+
+        BasicIterator& operator++() noexcept {
+            ++entry_;
+            return *this;
+        }
+
+        BasicIterator operator++(int) noexcept {
+            BasicIterator copy(*this);
+            ++entry_;
+            return copy;
+        }
+
+        BasicIterator& operator--() noexcept {
+            --entry_;
+            return *this;
+        }
+
+        BasicIterator operator--(int) noexcept {
+            BasicIterator copy(*this);
+            --entry_;
+            return copy;
+        }
+
+        BasicIterator& operator+=(difference_type n) noexcept {
+            entry_ += n;
+            return *this;
+        }
+
+        BasicIterator& operator-=(difference_type n) noexcept {
+            entry_ -= n;
+            return *this;
+        }
+
+        friend BasicIterator operator+(BasicIterator it, difference_type n) noexcept {
+            return it += n;
+        }
+
+        friend BasicIterator operator-(BasicIterator it, difference_type n) noexcept {
+            return it -= n;
+        }
+
+        friend difference_type operator-(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.entry_ - rhs.entry_;
+        }
+
+        friend bool operator==(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.entry_ == rhs.entry_;
+        }
+
+        friend bool operator!=(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.entry_ != rhs.entry_;
+        }
+
+        friend bool operator<(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.entry_ < rhs.entry_;
+        }
+
+    private:
+        const Entry* entry_ = nullptr;
+        unsigned char* data_ = nullptr;
+    };
+
+    using iterator = BasicIterator<Base>;
+    using const_iterator = BasicIterator<const Base>;
+
+    PolyVector() = default;
+
+    PolyVector(const PolyVector&) = delete;
+    PolyVector& operator=(const PolyVector&) = delete;
+
+    PolyVector(PolyVector&& other) noexcept {
+        Swap(other);
+    }
+
+    PolyVector& operator=(PolyVector&& rhs) noexcept {
+        if (this != &rhs) {
+            Swap(rhs);
+        }
+        return *this;
+    }
+
+    ~PolyVector() {
+        DestroyAll(data_.GetAddress());
+    }
+
+    void Swap(PolyVector& other) noexcept {
+        data_.Swap(other.data_);
+        entries_.Swap(other.entries_);
+        std::swap(size_bytes_, other.size_bytes_);
+    }
+
+    iterator begin() noexcept {
+        return iterator(entries_.begin(), data_.GetAddress());
+    }
+
+    iterator end() noexcept {
+        return iterator(entries_.end(), data_.GetAddress());
+    }
+
+    const_iterator begin() const noexcept {
+        return const_iterator(entries_.begin(), const_cast<unsigned char*>(data_.GetAddress()));
+    }
+
+    const_iterator end() const noexcept {
+        return const_iterator(entries_.end(), const_cast<unsigned char*>(data_.GetAddress()));
+    }
+
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    size_t Size() const noexcept {
+        return entries_.Size();
+    }
+
+    size_t SizeBytes() const noexcept {
+        return size_bytes_;
+    }
+
+    size_t CapacityBytes() const noexcept {
+        return data_.Capacity();
+    }
+
+    const Base& operator[](size_t index) const noexcept {
+        return const_cast<PolyVector&>(*this)[index];
+    }
+
+    Base& operator[](size_t index) noexcept {
+        assert(index < Size());
+        return *reinterpret_cast<Base*>(data_.GetAddress() + entries_[index].base_offset);
+    }
+
+    void Reserve(size_t count, size_t bytes) {
+        entries_.Reserve(count);
+        if (bytes > data_.Capacity()) {
+            RawMemory<unsigned char> new_data(bytes);
+            Relocate(new_data);
+            DestroyAll(data_.GetAddress());
+            data_.Swap(new_data);
+        }
+    }
+
+    template <typename Derived, typename... Args>
+    Derived& EmplaceBack(Args&&... args) {
+        static_assert(std::is_base_of_v<Base, Derived>, "Derived must inherit from Base");
+        static_assert(alignof(Derived) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__,
+                      "Over-aligned types are not supported");
+
+        const size_t offset = AlignUp(size_bytes_, alignof(Derived));
+        const size_t new_size_bytes = offset + sizeof(Derived);
+        if (entries_.Size() == entries_.Capacity()) {
+            entries_.Reserve(entries_.Size() == 0 ? 1 : entries_.Size() * 2);
+        }
+
+        Derived* object = nullptr;
+        if (new_size_bytes > data_.Capacity()) {
+            RawMemory<unsigned char> new_data(std::max(new_size_bytes, data_.Capacity() * 2));
+            object = new (new_data + offset) Derived(std::forward<Args>(args)...);
+            try {
+                Relocate(new_data);
+            } catch (...) {
+                std::destroy_at(object);
+                throw;
+            }
+            DestroyAll(data_.GetAddress());
+            data_.Swap(new_data);
+        } else {
+            object = new (data_ + offset) Derived(std::forward<Args>(args)...);
+        }
+
+        const auto* base = static_cast<const Base*>(object);
+        const size_t base_offset = offset
+            + (reinterpret_cast<const unsigned char*>(base) - reinterpret_cast<const unsigned char*>(object));
+        entries_.PushBack(Entry{offset, base_offset, &kOps<Derived>});
+        size_bytes_ = new_size_bytes;
+        return *object;
+    }
+
+    void PopBack() noexcept {
+        assert(Size() > 0);
+        const Entry& last = entries_[Size() - 1];
+        last.ops->destroy(data_ + last.object_offset);
+        size_bytes_ = last.object_offset;
+        entries_.PopBack();
+    }
+
+    void Clear() noexcept {
+        DestroyAll(data_.GetAddress());
+        entries_.Resize(0);
+        size_bytes_ = 0;
+    }
+
+private:
+    template <typename Derived>
+    static constexpr TypeOps kOps{
+        [](unsigned char* from, unsigned char* to) {
+            Derived* source = reinterpret_cast<Derived*>(from);
+            if constexpr (std::is_nothrow_move_constructible_v<Derived>
+                          || !std::is_copy_constructible_v<Derived>) {
+                new (to) Derived(std::move(*source));
+            } else {
+                new (to) Derived(*source);
+            }
+        },
+        [](unsigned char* object) noexcept {
+            std::destroy_at(reinterpret_cast<Derived*>(object));
+        },
+    };
+
+    static constexpr size_t AlignUp(size_t offset, size_t alignment) noexcept {
+        return (offset + alignment - 1) / alignment * alignment;
+    }
+
+    // Смещения объектов сохраняются: начало буфера выровнено одинаково
+    void Relocate(RawMemory<unsigned char>& new_data) {
+        size_t relocated = 0;
+        try {
+            for (; relocated < entries_.Size(); ++relocated) {
+                const Entry& entry = entries_[relocated];
+                entry.ops->relocate(data_ + entry.object_offset, new_data + entry.object_offset);
+            }
+        } catch (...) {
+            for (size_t i = 0; i < relocated; ++i) {
+                entries_[i].ops->destroy(new_data + entries_[i].object_offset);
+            }
+            throw;
+        }
+    }
+
+    void DestroyAll(unsigned char* data) noexcept {
+        for (const Entry& entry : entries_) {
+            entry.ops->destroy(data + entry.object_offset);
+        }
+    }
+
+    RawMemory<unsigned char> data_;
+    Vector<Entry> entries_;
+    size_t size_bytes_ = 0;
+};
@@ -0,0 +1,184 @@
+#pragma once
+
+#include "span.h"
+#include "vector.h"
+
+#include <cassert>
+#include <type_traits>
+
+// Числовой вектор с деревом Фенвика: изменение элемента и префиксная
+// сумма за O(log n) вместо пересчёта std::partial_sum. Ячейка tree_[k]
+// (с единицы) хранит сумму значений с номерами (k - lowbit(k), k]
+template <typename T>
+class PrefixSumVector {
+    static_assert(std::is_arithmetic_v<T>, "PrefixSumVector stores numbers");
+
+public:
+    PrefixSumVector() = default;
+
+    explicit PrefixSumVector(size_t size)
+        : values_(size)
+        , tree_(size + 1) {
+    }
+
+    explicit PrefixSumVector(Span<const T> values) {
+        Append(values);
+    }
+
+    size_t Size() const noexcept {
+        return values_.Size();
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        return values_[index];
+    }
+
+    Span<const T> Values() const noexcept {
+        return values_;
+    }
+
+    void Add(size_t index, T delta) noexcept {
+        assert(index < Size());
+        values_[index] += delta;
+        for (size_t k = index + 1; k < tree_.Size(); k += LowBit(k)) {
+            tree_[k] += delta;
+        }
+    }
+
+    void Set(size_t index, T value) noexcept {
+        Add(index, value - values_[index]);
+    }
+
+    // Сумма элементов с номерами [0, index]
+    T PrefixSum(size_t index) const noexcept {
+        assert(index < Size());
+        T sum{};
+        for (size_t k = index + 1; k > 0; k -= LowBit(k)) {
+            sum += tree_[k];
+        }
+        return sum;
+    }
+
+    // Сумма элементов с номерами [first, last)
+    T RangeSum(size_t first, size_t last) const noexcept {
+        assert(first <= last && last <= Size());
+        if (first == last) {
+            return T{};
+        }
+        const T upper = PrefixSum(last - 1);
+        return first == 0 ? upper : upper - PrefixSum(first - 1);
+    }
+
+    T Total() const noexcept {
+        return Size() == 0 ? T{} : PrefixSum(Size() - 1);
+    }
+
+    // Наименьший index, для которого PrefixSum(index) > target, или Size().
+    // Значения должны быть неотрицательными: тогда при target из [0, Total())
+    // элемент выбирается с вероятностью, пропорциональной его весу
+    size_t Search(T target) const noexcept {
+        size_t position = 0;
+        for (size_t step = HighBit(tree_.Size() - 1); step > 0; step /= 2) {
+            const size_t next = position + step;
+            if (next < tree_.Size() && !(target < tree_[next])) {
+                position = next;
+                target -= tree_[next];
+            }
+        }
+        return position;
+    }
+
+    // Добавление в конец за O(log n): новая ячейка дерева собирается
+    // из уже посчитанных ячеек
+    void PushBack(T value) {
+        if (tree_.Size() == 0) {
+            tree_.PushBack(T{});
+        }
+        values_.PushBack(value);
+        const size_t k = values_.Size();
+        T cell = value;
+        for (size_t step = 1; step < LowBit(k); step *= 2) {
+            cell += tree_[k - step];
+        }
+        try {
+            tree_.PushBack(cell);
+        } catch (...) {
+            values_.PopBack();
+            throw;
+        }
+    }
+
+    void PopBack() noexcept {
+        assert(Size() > 0);
+        values_.PopBack();
+        tree_.PopBack();
+    }
+
+    // Большая пачка дописывается целиком и дерево перестраивается за O(n)
+    void Append(Span<const T> values) {
+        if (values.Size() < Size() / 8) {
+            for (const T& value : values) {
+                PushBack(value);
+            }
+            return;
+        }
+        const size_t old_size = Size();
+        values_.Reserve(old_size + values.Size());
+        for (const T& value : values) {
+            values_.PushBack(value);
+        }
+        try {
+            Rebuild();
+        } catch (...) {
+            values_.Resize(old_size);
+            throw;
+        }
+    }
+
+    // Новые элементы равны нулю
+    void Resize(size_t new_size) {
+        if (new_size < Size()) {
+            values_.Resize(new_size);
+            tree_.Resize(new_size + 1);
+        } else if (new_size > Size()) {
+            const size_t old_size = Size();
+            values_.Resize(new_size);
+            try {
+                Rebuild();
+            } catch (...) {
+                values_.Resize(old_size);
+                throw;
+            }
+        }
+    }
+
+private:
+    static size_t LowBit(size_t k) noexcept {
+        return k & (~k + 1);
+    }
+
+    static size_t HighBit(size_t k) noexcept {
+        size_t bit = 1;
+        while (bit <= k / 2) {
+            bit *= 2;
+        }
+        return k == 0 ? 0 : bit;
+    }
+
+    // Построение за O(n): каждая готовая ячейка прибавляется к родителю
+    void Rebuild() {
+        Vector<T> tree(values_.Size() + 1);
+        for (size_t k = 1; k < tree.Size(); ++k) {
+            tree[k] = values_[k - 1];
+        }
+        for (size_t k = 1; k < tree.Size(); ++k) {
+            if (const size_t parent = k + LowBit(k); parent < tree.Size()) {
+                tree[parent] += tree[k];
+            }
+        }
+        tree_.Swap(tree);
+    }
+
+    Vector<T> values_;
+    Vector<T> tree_;
+};
@@ -0,0 +1,157 @@
+#pragma once
+
+#include "span.h"
+#include "vector.h"
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+namespace detail {
+
+template <typename T>
+using RadixKey = std::conditional_t<
+    sizeof(T) == 8, uint64_t,
+    std::conditional_t<sizeof(T) == 4, uint32_t, std::conditional_t<sizeof(T) == 2, uint16_t, uint8_t>>>;
+
+// Целые числа и float/double: у long double ключ не помещается в 64 бита
+// и в объекте есть незначащие байты
+template <typename T>
+constexpr bool kIsRadixSortable =
+    std::is_integral_v<T> || (std::is_floating_point_v<T> && sizeof(T) <= sizeof(uint64_t));
+
+constexpr size_t kRadixBits = 8;
+constexpr size_t kRadixBuckets = size_t{1} << kRadixBits;
+
+// Беззнаковый ключ с тем же порядком, что у значения: у знаковых целых
+// инвертируется знаковый бит, у отрицательных чисел с плавающей точкой -
+// все биты, у неотрицательных - только знаковый
+template <typename T>
+RadixKey<T> ToRadixKey(T value) noexcept {
+    using Key = RadixKey<T>;
+    constexpr Key kSignBit = Key{1} << (sizeof(T) * 8 - 1);
+    Key bits;
+    std::memcpy(&bits, &value, sizeof(T));
+    if constexpr (std::is_floating_point_v<T>) {
+        return bits ^ ((bits & kSignBit) != 0 ? static_cast<Key>(~Key{0}) : kSignBit);
+    } else if constexpr (std::is_signed_v<T>) {
+        return bits ^ kSignBit;
+    } else {
+        return bits;
+    }
+}
+
+struct NoRadixValues {};
+
+// Поразрядная сортировка от младшего разряда: гистограммы всех разрядов
+// строятся за один проход, разряд, одинаковый у всех ключей, пропускается.
+// Ключи (и значения, если V не NoRadixValues) переходят между основным
+// и вспомогательным буфером; возвращает true, если итог во вспомогательном
+template <typename T, typename V>
+bool RadixSortPasses(T* keys, T* key_buffer, V* values, V* value_buffer, size_t size) noexcept {
+    constexpr size_t kDigits = sizeof(T) * 8 / kRadixBits;
+    size_t counts[kDigits][kRadixBuckets] = {};
+    for (size_t i = 0; i < size; ++i) {
+        const auto key = ToRadixKey(keys[i]);
+        for (size_t digit = 0; digit < kDigits; ++digit) {
+            ++counts[digit][(key >> (digit * kRadixBits)) & (kRadixBuckets - 1)];
+        }
+    }
+
+    bool in_buffer = false;
+    for (size_t digit = 0; digit < kDigits; ++digit) {
+        const size_t shift = digit * kRadixBits;
+        size_t* offsets = counts[digit];
+        if (offsets[(ToRadixKey(keys[0]) >> shift) & (kRadixBuckets - 1)] == size) {
+            continue;
+        }
+        size_t total = 0;
+        for (size_t bucket = 0; bucket < kRadixBuckets; ++bucket) {
+            const size_t count = offsets[bucket];
+            offsets[bucket] = total;
+            total += count;
+        }
+        for (size_t i = 0; i < size; ++i) {
+            const size_t position = offsets[(ToRadixKey(keys[i]) >> shift) & (kRadixBuckets - 1)]++;
+            key_buffer[position] = keys[i];
+            if constexpr (!std::is_same_v<V, NoRadixValues>) {
+                value_buffer[position] = values[i];
+            }
+        }
+        std::swap(keys, key_buffer);
+        std::swap(values, value_buffer);
+        in_buffer = !in_buffer;
+    }
+    return in_buffer;
+}
+
+}  // namespace detail
+
+// Сортировка по возрастанию целых чисел и чисел с плавающей точкой.
+// Отрицательный ноль идёт перед положительным, NaN со знаком минус -
+// в начало, остальные NaN - в конец. scratch переиспользуется между
+// вызовами и при нехватке места выделяется заново
+template <typename T>
+void RadixSort(Vector<T>& values, RawMemory<T>& scratch) {
+    static_assert(detail::kIsRadixSortable<T>, "RadixSort orders integers, float and double");
+    const size_t size = values.Size();
+    if (size < 2) {
+        return;
+    }
+    if (scratch.Capacity() < size) {
+        RawMemory<T>(size).Swap(scratch);
+    }
+    T* data = values.begin();
+    T* buffer = scratch.GetAddress();
+    detail::NoRadixValues* no_values = nullptr;
+    if (detail::RadixSortPasses(data, buffer, no_values, no_values, size)) {
+        std::memcpy(data, buffer, size * sizeof(T));
+    }
+}
+
+template <typename T>
+void RadixSort(Vector<T>& values) {
+    RawMemory<T> scratch;
+    RadixSort(values, scratch);
+}
+
+// Устойчивая сортировка пар: values переставляются вместе с keys
+template <typename K, typename V>
+void RadixSortByKey(Vector<K>& keys, Vector<V>& values) {
+    static_assert(detail::kIsRadixSortable<K>, "RadixSortByKey orders integer, float and double keys");
+    static_assert(std::is_trivially_copyable_v<V>, "RadixSortByKey moves values bytewise");
+    assert(keys.Size() == values.Size());
+    const size_t size = keys.Size();
+    if (size < 2) {
+        return;
+    }
+    RawMemory<K> key_scratch(size);
+    RawMemory<V> value_scratch(size);
+    if (detail::RadixSortPasses(keys.begin(), key_scratch.GetAddress(), values.begin(), value_scratch.GetAddress(),
+                                size)) {
+        std::memcpy(keys.begin(), key_scratch.GetAddress(), size * sizeof(K));
+        std::memcpy(static_cast<void*>(values.begin()), value_scratch.GetAddress(), size * sizeof(V));
+    }
+}
+
+// Перестановка, упорядочивающая keys: keys[order[0]] <= keys[order[1]] <= ...
+// Равные ключи сохраняют исходный порядок
+template <typename T>
+Vector<size_t> RadixArgsort(Span<const T> keys) {
+    Vector<T> sorted_keys(keys.Size());
+    Vector<size_t> order(keys.Size());
+    for (size_t i = 0; i < keys.Size(); ++i) {
+        sorted_keys[i] = keys[i];
+        order[i] = i;
+    }
+    RadixSortByKey(sorted_keys, order);
+    return order;
+}
+
+// Перегрузка для Vector: Span<const T> не выводится из аргумента Vector<T>
+template <typename T>
+Vector<size_t> RadixArgsort(const Vector<T>& keys) {
+    return RadixArgsort(Span<const T>(keys));
+}
@@ -0,0 +1,182 @@
+#pragma once
+
+#include "span.h"
+#include "vector.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+// Вектор с кодированием длин серий: подряд идущие равные значения
+// хранятся одной серией (значение, конец серии)
+template <typename T>
+class RleVector {
+public:
+    class ConstIterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        ConstIterator() = default;
+
+        ConstIterator(const RleVector* owner, size_t position, size_t run) noexcept
+            : owner_(owner)
+            , position_(position)
+            , run_(run) {
+        }
+
+        reference operator*() const noexcept {
+            return owner_->values_[run_];
+        }
+
+        pointer operator->() const noexcept {
+            return &**this;
+        }
+
+        ConstIterator& operator++() noexcept {
+            if (++position_ == owner_->ends_[run_]) {
+                ++run_;
+            }
+            return *this;
+        }
+
+        ConstIterator operator++(int) noexcept {
+            ConstIterator copy(*this);
+            ++*this;
+            return copy;
+        }
+
+        friend bool operator==(const ConstIterator& lhs, const ConstIterator& rhs) noexcept {
+            return lhs.position_ == rhs.position_;
+        }
+
+        friend bool operator!=(const ConstIterator& lhs, const ConstIterator& rhs) noexcept {
+            return lhs.position_ != rhs.position_;
+        }
+
+    private:
+        const RleVector* owner_ = nullptr;
+        size_t position_ = 0;
+        size_t run_ = 0;
+    };
+
+    using const_iterator = ConstIterator;
+
+    RleVector() = default;
+
+    explicit RleVector(Span<const T> values) {
+        for (const T& value : values) {
+            PushBack(value);
+        }
+    }
+
+    Vector<T> ToVector() const {
+        Vector<T> result;
+        result.Reserve(Size());
+        ForEachRun([&result](const T& value, size_t length) {
+            for (size_t i = 0; i < length; ++i) {
+                result.PushBack(value);
+            }
+        });
+        return result;
+    }
+
+    const_iterator begin() const noexcept {
+        return const_iterator(this, 0, 0);
+    }
+
+    const_iterator end() const noexcept {
+        return const_iterator(this, Size(), RunCount());
+    }
+
+    size_t Size() const noexcept {
+        return ends_.Size() == 0 ? 0 : ends_[ends_.Size() - 1];
+    }
+
+    size_t RunCount() const noexcept {
+        return values_.Size();
+    }
+
+    // O(log RunCount()): двоичный поиск по концам серий
+    const T& operator[](size_t index) const noexcept {
+        assert(index < Size());
+        return values_[RunIndex(index)];
+    }
+
+    size_t RunIndex(size_t index) const noexcept {
+        return std::upper_bound(ends_.begin(), ends_.end(), index) - ends_.begin();
+    }
+
+    // Добавляет count копий value, сливая их с последней серией при равенстве
+    void PushBack(const T& value, size_t count = 1) {
+        if (count == 0) {
+            return;
+        }
+        if (RunCount() > 0 && values_[RunCount() - 1] == value) {
+            ends_[RunCount() - 1] += count;
+            return;
+        }
+        const size_t end = Size() + count;
+        values_.PushBack(value);
+        try {
+            ends_.PushBack(end);
+        } catch (...) {
+            values_.PopBack();
+            throw;
+        }
+    }
+
+    void PopBack() noexcept {
+        assert(Size() > 0);
+        const size_t last = RunCount() - 1;
+        const size_t run_begin = last == 0 ? 0 : ends_[last - 1];
+        if (--ends_[last] == run_begin) {
+            ends_.PopBack();
+            values_.PopBack();
+        }
+    }
+
+    // Вызывает func(value, length) для каждой серии по порядку
+    template <typename Func>
+    void ForEachRun(Func func) const {
+        size_t run_begin = 0;
+        for (size_t run = 0; run < RunCount(); ++run) {
+            func(values_[run], ends_[run] - run_begin);
+            run_begin = ends_[run];
+        }
+    }
+
+    size_t Count(const T& value) const {
+        size_t count = 0;
+        ForEachRun([&count, &value](const T& run_value, size_t length) {
+            if (run_value == value) {
+                count += length;
+            }
+        });
+        return count;
+    }
+
+    // Сумма в расширенном типе: int64_t, uint64_t или double, поэтому
+    // длинные серии малых целых не переполняют T
+    using SumType = std::conditional_t<std::is_floating_point_v<T>, double,
+                                       std::conditional_t<std::is_signed_v<T>, int64_t, uint64_t>>;
+
+    SumType Sum() const {
+        static_assert(std::is_arithmetic_v<T>, "Sum requires an arithmetic type");
+        SumType sum{};
+        ForEachRun([&sum](const T& value, size_t length) {
+            sum += static_cast<SumType>(value) * static_cast<SumType>(length);
+        });
+        return sum;
+    }
+
+private:
+    Vector<T> values_;
+    Vector<size_t> ends_;
+};
@@ -0,0 +1,156 @@
+#pragma once
+
+#include "vector.h"
+
+#include <cassert>
+#include <cstdint>
+#include <utility>
+
+// Контейнер со стабильными дескрипторами: значения лежат плотно в Vector<T>,
+// дескриптор указывает на слот, а слот - на позицию значения.
+// Поколение слота растёт при каждом удалении, поэтому устаревший
+// дескриптор распознаётся за O(1)
+template <typename T>
+class SlotMap {
+public:
+    struct Handle {
+        uint32_t index = UINT32_MAX;
+        uint32_t generation = 0;
+
+        friend bool operator==(Handle lhs, Handle rhs) noexcept {
+            return lhs.index == rhs.index && lhs.generation == rhs.generation;
+        }
+
+        friend bool operator!=(Handle lhs, Handle rhs) noexcept {
+            return !(lhs == rhs);
+        }
+    };
+
+    using iterator = typename Vector<T>::iterator;
+    using const_iterator = typename Vector<T>::const_iterator;
+
+    SlotMap() = default;
+
+    iterator begin() noexcept {
+        return values_.begin();
+    }
+
+    iterator end() noexcept {
+        return values_.end();
+    }
+
+    const_iterator begin() const noexcept {
+        return values_.begin();
+    }
+
+    const_iterator end() const noexcept {
+        return values_.end();
+    }
+
+    size_t Size() const noexcept {
+        return values_.Size();
+    }
+
+    void Reserve(size_t capacity) {
+        values_.Reserve(capacity);
+        slot_of_value_.Reserve(capacity);
+        slots_.Reserve(capacity);
+    }
+
+    template <typename... Args>
+    Handle Emplace(Args&&... args) {
+        values_.EmplaceBack(std::forward<Args>(args)...);
+        const bool reuse_slot = free_head_ != kNoSlot;
+        const uint32_t index = reuse_slot ? free_head_ : static_cast<uint32_t>(slots_.Size());
+        try {
+            if (!reuse_slot) {
+                slots_.PushBack(Slot{});
+            }
+            slot_of_value_.PushBack(index);
+        } catch (...) {
+            if (!reuse_slot && slots_.Size() > index) {
+                slots_.PopBack();
+            }
+            values_.PopBack();
+            throw;
+        }
+        Slot& slot = slots_[index];
+        if (reuse_slot) {
+            free_head_ = slot.target;
+        }
+        slot.target = static_cast<uint32_t>(values_.Size() - 1);
+        return Handle{index, slot.generation};
+    }
+
+    Handle Insert(const T& value) {
+        return Emplace(value);
+    }
+
+    Handle Insert(T&& value) {
+        return Emplace(std::move(value));
+    }
+
+    bool Contains(Handle handle) const noexcept {
+        return handle.index < slots_.Size() && slots_[handle.index].generation == handle.generation;
+    }
+
+    // nullptr для устаревшего дескриптора
+    T* Find(Handle handle) noexcept {
+        return Contains(handle) ? &values_[slots_[handle.index].target] : nullptr;
+    }
+
+    const T* Find(Handle handle) const noexcept {
+        return const_cast<SlotMap&>(*this).Find(handle);
+    }
+
+    T& operator[](Handle handle) noexcept {
+        assert(Contains(handle));
+        return values_[slots_[handle.index].target];
+    }
+
+    const T& operator[](Handle handle) const noexcept {
+        return const_cast<SlotMap&>(*this)[handle];
+    }
+
+    // Последнее значение переносится на место удалённого
+    bool Erase(Handle handle) {
+        if (!Contains(handle)) {
+            return false;
+        }
+        Slot& slot = slots_[handle.index];
+        const uint32_t position = slot.target;
+        const uint32_t last = static_cast<uint32_t>(values_.Size() - 1);
+        if (position != last) {
+            values_[position] = std::move(values_[last]);
+            slot_of_value_[position] = slot_of_value_[last];
+            slots_[slot_of_value_[position]].target = position;
+        }
+        values_.PopBack();
+        slot_of_value_.PopBack();
+
+        ++slot.generation;
+        slot.target = free_head_;
+        free_head_ = handle.index;
+        return true;
+    }
+
+    // Дескриптор значения по его позиции в плотном массиве
+    Handle HandleAt(size_t position) const noexcept {
+        const uint32_t index = slot_of_value_[position];
+        return Handle{index, slots_[index].generation};
+    }
+
+private:
+    static constexpr uint32_t kNoSlot = UINT32_MAX;
+
+    // target - позиция значения для занятого слота или следующий свободный слот
+    struct Slot {
+        uint32_t target = kNoSlot;
+        uint32_t generation = 0;
+    };
+
+    Vector<T> values_;
+    Vector<uint32_t> slot_of_value_;
+    Vector<Slot> slots_;
+    uint32_t free_head_ = kNoSlot;
+};
@@ -0,0 +1,344 @@
+#pragma once
+
+#include "span.h"
+#include "vector.h"
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// Вектор в раскладке "структура массивов": каждое поле хранится в своей
+// непрерывной колонке, все колонки лежат в одном блоке RawMemory
+template <typename... Ts>
+class SoAVector {
+    static_assert(sizeof...(Ts) > 0, "SoAVector requires at least one column");
+    static_assert(((alignof(Ts) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__) && ...),
+                  "Over-aligned column types are not supported");
+
+    static constexpr size_t N = sizeof...(Ts);
+    using Offsets = std::array<size_t, N>;
+
+public:
+    template <size_t I>
+    using ColumnType = std::tuple_element_t<I, std::tuple<Ts...>>;
+
+    using reference = std::tuple<Ts&...>;
+    using const_reference = std::tuple<const Ts&...>;
+    using value_type = std::tuple<Ts...>;
+
+    SoAVector() = default;
+
+    explicit SoAVector(size_t size)
+        : data_(BufferSize(size))
+        , offsets_(MakeOffsets(size))
+        , capacity_(size) {
+        ValueConstructRows(data_, offsets_, 0, size);
+        size_ = size;
+    }
+
+    SoAVector(const SoAVector& other)
+        : data_(BufferSize(other.size_))
+        , offsets_(MakeOffsets(other.size_))
+        , capacity_(other.size_) {
+        CopyColumns(other);
+        size_ = other.size_;
+    }
+
+    SoAVector(SoAVector&& other) noexcept {
+        Swap(other);
+    }
+
+    ~SoAVector() {
+        DestroyRows(data_, offsets_, 0, size_);
+    }
+
+    SoAVector& operator=(const SoAVector& rhs) {
+        if (this != &rhs) {
+            SoAVector rhs_copy(rhs);
+            Swap(rhs_copy);
+        }
+        return *this;
+    }
+
+    SoAVector& operator=(SoAVector&& rhs) noexcept {
+        if (this != &rhs) {
+            Swap(rhs);
+        }
+        return *this;
+    }
+
+    void Swap(SoAVector& other) noexcept {
+        data_.Swap(other.data_);
+        std::swap(offsets_, other.offsets_);
+        std::swap(capacity_, other.capacity_);
+        std::swap(size_, other.size_);
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    size_t Capacity() const noexcept {
+        return capacity_;
+    }
+
+    template <size_t I>
+    Span<ColumnType<I>> Column() noexcept {
+        return Span<ColumnType<I>>(ColumnData<I>(data_, offsets_), size_);
+    }
+
+    template <size_t I>
+    Span<const ColumnType<I>> Column() const noexcept {
+        return Span<const ColumnType<I>>(ColumnData<I>(data_, offsets_), size_);
+    }
+
+    reference operator[](size_t index) noexcept {
+        assert(index < size_);
+        return MakeRow(index, std::index_sequence_for<Ts...>{});
+    }
+
+    const_reference operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return MakeRow(index, std::index_sequence_for<Ts...>{});
+    }
+
+    void Reserve(size_t new_capacity) {
+        if (new_capacity <= capacity_) {
+            return;
+        }
+        RawMemory<unsigned char> new_data(BufferSize(new_capacity));
+        const Offsets new_offsets = MakeOffsets(new_capacity);
+        RelocateRows(new_data, new_offsets);
+        DestroyRows(data_, offsets_, 0, size_);
+        data_.Swap(new_data);
+        offsets_ = new_offsets;
+        capacity_ = new_capacity;
+    }
+
+    void Resize(size_t new_size) {
+        if (new_size < size_) {
+            DestroyRows(data_, offsets_, new_size, size_);
+            size_ = new_size;
+        } else if (new_size > size_) {
+            Reserve(new_size);
+            ValueConstructRows(data_, offsets_, size_, new_size);
+            size_ = new_size;
+        }
+    }
+
+    void PushBack(const Ts&... values) {
+        EmplaceBack(values...);
+    }
+
+    // Каждый аргумент инициализирует соответствующую колонку
+    template <typename... Args>
+    reference EmplaceBack(Args&&... args) {
+        static_assert(sizeof...(Args) == N, "EmplaceBack expects one argument per column");
+        if (size_ == capacity_) {
+            const size_t new_capacity = size_ == 0 ? 1 : size_ * 2;
+            RawMemory<unsigned char> new_data(BufferSize(new_capacity));
+            const Offsets new_offsets = MakeOffsets(new_capacity);
+            ConstructRow(new_data, new_offsets, size_, std::forward_as_tuple(std::forward<Args>(args)...));
+            try {
+                RelocateRows(new_data, new_offsets);
+            } catch (...) {
+                DestroyRows(new_data, new_offsets, size_, size_ + 1);
+                throw;
+            }
+            DestroyRows(data_, offsets_, 0, size_);
+            data_.Swap(new_data);
+            offsets_ = new_offsets;
+            capacity_ = new_capacity;
+        } else {
+            ConstructRow(data_, offsets_, size_, std::forward_as_tuple(std::forward<Args>(args)...));
+        }
+        ++size_;
+        return (*this)[size_ - 1];
+    }
+
+    size_t Erase(size_t index) {
+        assert(index < size_);
+        EraseColumns(index, std::index_sequence_for<Ts...>{});
+        PopBack();
+        return index;
+    }
+
+    void PopBack() noexcept {
+        assert(size_ > 0);
+        DestroyRows(data_, offsets_, size_ - 1, size_);
+        --size_;
+    }
+
+private:
+    template <typename U>
+    static constexpr bool kMoveOnRelocate = std::is_nothrow_move_constructible_v<U>
+                                            || !std::is_copy_constructible_v<U>;
+
+    static constexpr size_t AlignUp(size_t offset, size_t alignment) noexcept {
+        return (offset + alignment - 1) / alignment * alignment;
+    }
+
+    static Offsets MakeOffsets(size_t capacity) noexcept {
+        Offsets offsets{};
+        constexpr std::array<size_t, N> sizes{sizeof(Ts)...};
+        constexpr std::array<size_t, N> alignments{alignof(Ts)...};
+        size_t offset = 0;
+        for (size_t i = 0; i < N; ++i) {
+            offset = AlignUp(offset, alignments[i]);
+            offsets[i] = offset;
+            offset += sizes[i] * capacity;
+        }
+        return offsets;
+    }
+
+    static size_t BufferSize(size_t capacity) noexcept {
+        if (capacity == 0) {
+            return 0;
+        }
+        constexpr size_t last_size = sizeof(ColumnType<N - 1>);
+        return MakeOffsets(capacity)[N - 1] + last_size * capacity;
+    }
+
+    template <size_t I>
+    static ColumnType<I>* ColumnData(RawMemory<unsigned char>& data, const Offsets& offsets) noexcept {
+        return reinterpret_cast<ColumnType<I>*>(data.GetAddress() + offsets[I]);
+    }
+
+    template <size_t I>
+    static const ColumnType<I>* ColumnData(const RawMemory<unsigned char>& data,
+                                           const Offsets& offsets) noexcept {
+        return ColumnData<I>(const_cast<RawMemory<unsigned char>&>(data), offsets);
+    }
+
+    template <size_t... Is>
+    reference MakeRow(size_t index, std::index_sequence<Is...>) noexcept {
+        return reference(ColumnData<Is>(data_, offsets_)[index]...);
+    }
+
+    template <size_t... Is>
+    const_reference MakeRow(size_t index, std::index_sequence<Is...>) const noexcept {
+        return const_reference(ColumnData<Is>(data_, offsets_)[index]...);
+    }
+
+    template <size_t I = 0, typename ArgsTuple>
+    static void ConstructRow(RawMemory<unsigned char>& data, const Offsets& offsets, size_t index,
+                             ArgsTuple&& args) {
+        if constexpr (I < N) {
+            ColumnType<I>* slot = ColumnData<I>(data, offsets) + index;
+            new (slot) ColumnType<I>(std::get<I>(std::move(args)));
+            try {
+                ConstructRow<I + 1>(data, offsets, index, std::move(args));
+            } catch (...) {
+                std::destroy_at(slot);
+                throw;
+            }
+        }
+    }
+
+    template <size_t I = 0>
+    static void ValueConstructRows(RawMemory<unsigned char>& data, const Offsets& offsets,
+                                   size_t first, size_t last) {
+        if constexpr (I < N) {
+            ColumnType<I>* column = ColumnData<I>(data, offsets);
+            std::uninitialized_value_construct_n(column + first, last - first);
+            try {
+                ValueConstructRows<I + 1>(data, offsets, first, last);
+            } catch (...) {
+                std::destroy_n(column + first, last - first);
+                throw;
+            }
+        }
+    }
+
+    template <size_t I = 0>
+    void CopyColumns(const SoAVector& other) {
+        if constexpr (I < N) {
+            ColumnType<I>* column = ColumnData<I>(data_, offsets_);
+            std::uninitialized_copy_n(ColumnData<I>(other.data_, other.offsets_), other.size_, column);
+            try {
+                CopyColumns<I + 1>(other);
+            } catch (...) {
+                std::destroy_n(column, other.size_);
+                throw;
+            }
+        }
+    }
+
+    // Колонки, которые переносятся копированием, обрабатываются первыми:
+    // если копирование бросит исключение, исходные колонки ещё не тронуты
+    template <bool kMovePass, size_t I = 0>
+    void RelocateColumns(RawMemory<unsigned char>& new_data, const Offsets& new_offsets) {
+        if constexpr (I < N) {
+            using U = ColumnType<I>;
+            if constexpr (kMoveOnRelocate<U> == kMovePass) {
+                U* from = ColumnData<I>(data_, offsets_);
+                U* to = ColumnData<I>(new_data, new_offsets);
+                if constexpr (kMovePass) {
+                    std::uninitialized_move_n(from, size_, to);
+                } else {
+                    std::uninitialized_copy_n(from, size_, to);
+                }
+                try {
+                    RelocateColumns<kMovePass, I + 1>(new_data, new_offsets);
+                } catch (...) {
+                    std::destroy_n(to, size_);
+                    throw;
+                }
+            } else {
+                RelocateColumns<kMovePass, I + 1>(new_data, new_offsets);
+            }
+        }
+    }
+
+    template <bool kMovePass, size_t I = 0>
+    void DestroyColumns(RawMemory<unsigned char>& data, const Offsets& offsets) noexcept {
+        if constexpr (I < N) {
+            if constexpr (kMoveOnRelocate<ColumnType<I>> == kMovePass) {
+                std::destroy_n(ColumnData<I>(data, offsets), size_);
+            }
+            DestroyColumns<kMovePass, I + 1>(data, offsets);
+        }
+    }
+
+    void RelocateRows(RawMemory<unsigned char>& new_data, const Offsets& new_offsets) {
+        if (size_ == 0) {
+            return;
+        }
+        RelocateColumns<false>(new_data, new_offsets);
+        try {
+            RelocateColumns<true>(new_data, new_offsets);
+        } catch (...) {
+            DestroyColumns<false>(new_data, new_offsets);
+            throw;
+        }
+    }
+
+    static void DestroyRows(RawMemory<unsigned char>& data, const Offsets& offsets,
+                            size_t first, size_t last) noexcept {
+        DestroyRowsImpl(data, offsets, first, last, std::index_sequence_for<Ts...>{});
+    }
+
+    template <size_t... Is>
+    static void DestroyRowsImpl(RawMemory<unsigned char>& data, const Offsets& offsets,
+                                size_t first, size_t last, std::index_sequence<Is...>) noexcept {
+        (std::destroy_n(ColumnData<Is>(data, offsets) + first, last - first), ...);
+    }
+
+    template <size_t... Is>
+    void EraseColumns(size_t index, std::index_sequence<Is...>) {
+        ((std::move(ColumnData<Is>(data_, offsets_) + index + 1,
+                    ColumnData<Is>(data_, offsets_) + size_,
+                    ColumnData<Is>(data_, offsets_) + index)),
+         ...);
+    }
+
+    RawMemory<unsigned char> data_;
+    Offsets offsets_{};
+    size_t capacity_ = 0;
+    size_t size_ = 0;
+};
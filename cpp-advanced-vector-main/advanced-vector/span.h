@@ -0,0 +1,92 @@
+#pragma once
+
+#include "vector.h"
+
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+
+namespace detail {
+
+// Аналог std::type_identity_t из C++20: параметр вида Span<NonDeduced<T>>
+// не участвует в выводе T, поэтому в него можно передать Vector<T>
+template <typename T>
+struct TypeIdentity {
+    using type = T;
+};
+
+template <typename T>
+using NonDeduced = typename TypeIdentity<T>::type;
+
+}  // namespace detail
+
+// Невладеющий вид на непрерывный участок памяти (аналог std::span из C++20)
+template <typename T>
+class Span {
+public:
+    using iterator = T*;
+
+    Span() = default;
+
+    Span(T* data, size_t size) noexcept
+        : data_(data)
+        , size_(size) {
+    }
+
+    Span(T* first, T* last) noexcept
+        : data_(first)
+        , size_(last - first) {
+    }
+
+    template <typename U, typename = std::enable_if_t<std::is_convertible_v<U (*)[], T (*)[]>>>
+    Span(Span<U> other) noexcept
+        : data_(other.Data())
+        , size_(other.Size()) {
+    }
+
+    template <typename U, typename = std::enable_if_t<std::is_convertible_v<U (*)[], T (*)[]>>>
+    Span(Vector<U>& vector) noexcept
+        : data_(vector.begin())
+        , size_(vector.Size()) {
+    }
+
+    template <typename U, typename = std::enable_if_t<std::is_convertible_v<const U (*)[], T (*)[]>>>
+    Span(const Vector<U>& vector) noexcept
+        : data_(vector.begin())
+        , size_(vector.Size()) {
+    }
+
+    iterator begin() const noexcept {
+        return data_;
+    }
+
+    iterator end() const noexcept {
+        return data_ + size_;
+    }
+
+    T* Data() const noexcept {
+        return data_;
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    bool Empty() const noexcept {
+        return size_ == 0;
+    }
+
+    T& operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return data_[index];
+    }
+
+    Span Subspan(size_t offset, size_t count) const noexcept {
+        assert(offset + count <= size_);
+        return Span(data_ + offset, count);
+    }
+
+private:
+    T* data_ = nullptr;
+    size_t size_ = 0;
+};
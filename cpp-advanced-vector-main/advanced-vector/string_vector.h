@@ -0,0 +1,187 @@
+#pragma once
+
+#include "span.h"
+#include "vector.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <ios>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+
+// Вектор строк, символы которых лежат подряд в одной арене Vector<char>,
+// а каждая строка описывается парой (смещение, длина)
+template <typename OffsetType>
+class BasicStringVector {
+    static_assert(std::is_unsigned_v<OffsetType>, "OffsetType must be an unsigned integer");
+
+public:
+    struct Slice {
+        OffsetType offset;
+        OffsetType length;
+    };
+
+    BasicStringVector() = default;
+
+    size_t Size() const noexcept {
+        return slices_.Size();
+    }
+
+    bool Empty() const noexcept {
+        return slices_.Size() == 0;
+    }
+
+    size_t CharCount() const noexcept {
+        return chars_.Size();
+    }
+
+    std::string_view operator[](size_t index) const noexcept {
+        assert(index < Size());
+        const Slice& slice = slices_[index];
+        return std::string_view(chars_.begin() + slice.offset, slice.length);
+    }
+
+    Span<const char> Chars() const noexcept {
+        return chars_;
+    }
+
+    Span<const Slice> Slices() const noexcept {
+        return slices_;
+    }
+
+    void Reserve(size_t count, size_t chars) {
+        slices_.Reserve(count);
+        chars_.Reserve(chars);
+    }
+
+    std::string_view EmplaceBack(std::string_view value) {
+        const size_t offset = chars_.Size();
+        if (offset + value.size() > std::numeric_limits<OffsetType>::max()) {
+            throw std::length_error("BasicStringVector: character arena overflows OffsetType");
+        }
+        if (slices_.Size() == slices_.Capacity()) {
+            slices_.Reserve(slices_.Size() == 0 ? 1 : slices_.Size() * 2);
+        }
+        if (offset + value.size() > chars_.Capacity()) {
+            // value может указывать в собственную арену, которую Reserve освободит
+            const char* arena = chars_.begin();
+            const bool aliases = !value.empty() && !std::less<const char*>{}(value.data(), arena)
+                && std::less<const char*>{}(value.data(), arena + offset);
+            const size_t source = aliases ? static_cast<size_t>(value.data() - arena) : 0;
+            chars_.Reserve(std::max(offset + value.size(), chars_.Capacity() * 2));
+            if (aliases) {
+                value = std::string_view(chars_.begin() + source, value.size());
+            }
+        }
+        chars_.Resize(offset + value.size());
+        std::copy(value.begin(), value.end(), chars_.begin() + offset);
+        slices_.PushBack(Slice{static_cast<OffsetType>(offset), static_cast<OffsetType>(value.size())});
+        return (*this)[Size() - 1];
+    }
+
+    void PushBack(std::string_view value) {
+        EmplaceBack(value);
+    }
+
+    // Символы возвращаются в арену, только если строка лежит в её конце
+    void PopBack() noexcept {
+        assert(Size() > 0);
+        const Slice& last = slices_[Size() - 1];
+        if (static_cast<size_t>(last.offset) + last.length == chars_.Size()) {
+            chars_.Resize(last.offset);
+        }
+        slices_.PopBack();
+    }
+
+    void Clear() noexcept {
+        slices_.Resize(0);
+        chars_.Resize(0);
+    }
+
+    // Сортирует только таблицу срезов, символы в арене не перемещаются
+    void Sort() {
+        const char* chars = chars_.begin();
+        std::sort(slices_.begin(), slices_.end(), [chars](const Slice& lhs, const Slice& rhs) {
+            return std::string_view(chars + lhs.offset, lhs.length)
+                 < std::string_view(chars + rhs.offset, rhs.length);
+        });
+    }
+
+    void WriteTo(std::ostream& out) const {
+        const uint64_t header[2] = {slices_.Size(), chars_.Size()};
+        out.write(reinterpret_cast<const char*>(header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(slices_.begin()), slices_.Size() * sizeof(Slice));
+        out.write(chars_.begin(), chars_.Size());
+    }
+
+    static BasicStringVector ReadFrom(std::istream& in) {
+        uint64_t header[2] = {};
+        if (!in.read(reinterpret_cast<char*>(header), sizeof(header))) {
+            throw std::runtime_error("BasicStringVector: truncated header");
+        }
+        // Размеры сверяются с данными до выделения памяти
+        if (header[0] > std::numeric_limits<size_t>::max() / sizeof(Slice)
+            || header[1] > std::numeric_limits<OffsetType>::max()) {
+            throw std::runtime_error("BasicStringVector: sizes out of range");
+        }
+        const uint64_t payload = header[0] * sizeof(Slice) + header[1];
+        if (payload < header[1] || payload > RemainingBytes(in)) {
+            throw std::runtime_error("BasicStringVector: truncated data");
+        }
+        BasicStringVector result;
+        ReadChunked(in, result.slices_, header[0]);
+        ReadChunked(in, result.chars_, header[1]);
+        for (const Slice& slice : result.slices_) {
+            if (static_cast<uint64_t>(slice.offset) + slice.length > header[1]) {
+                throw std::runtime_error("BasicStringVector: slice out of range");
+            }
+        }
+        return result;
+    }
+
+private:
+    static constexpr size_t kReadChunkBytes = 1 << 16;
+
+    // Остаток потока в байтах или максимум, если поток не позволяет
+    // позиционирование
+    static uint64_t RemainingBytes(std::istream& in) {
+        const std::istream::pos_type position = in.tellg();
+        if (position == std::istream::pos_type(-1) || !in.seekg(0, std::ios::end)) {
+            in.clear();
+            return std::numeric_limits<uint64_t>::max();
+        }
+        const std::istream::pos_type end = in.tellg();
+        in.seekg(position);
+        return static_cast<uint64_t>(end - position);
+    }
+
+    // Массив растёт по мере чтения, поэтому ложный заголовок в потоке без
+    // позиционирования не приводит к огромному выделению памяти
+    template <typename U>
+    static void ReadChunked(std::istream& in, Vector<U>& values, uint64_t count) {
+        const size_t chunk = std::max<size_t>(1, kReadChunkBytes / sizeof(U));
+        while (values.Size() < count) {
+            const size_t old_size = values.Size();
+            const size_t step = static_cast<size_t>(std::min<uint64_t>(chunk, count - old_size));
+            if (old_size + step > values.Capacity()) {
+                values.Reserve(static_cast<size_t>(std::min<uint64_t>(count, std::max(old_size + step, old_size * 2))));
+            }
+            values.Resize(old_size + step);
+            if (!in.read(reinterpret_cast<char*>(values.begin() + old_size), step * sizeof(U))) {
+                throw std::runtime_error("BasicStringVector: truncated data");
+            }
+        }
+    }
+
+    Vector<char> chars_;
+    Vector<Slice> slices_;
+};
+
+using StringVector = BasicStringVector<uint32_t>;
+using LargeStringVector = BasicStringVector<uint64_t>;
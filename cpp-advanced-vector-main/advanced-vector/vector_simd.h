@@ -0,0 +1,339 @@
+#pragma once
+
+#include "span.h"
+#include "vector.h"
+
+#include <cassert>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+// Выбор набора инструкций во время выполнения доступен на x86 в GCC и Clang
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define VECTOR_SIMD_DISPATCH 1
+#define VECTOR_SIMD_INLINE __attribute__((always_inline)) inline
+// GCC до -O3 векторизует только самые простые циклы, поэтому варианты
+// ядер собираются с полной векторизацией независимо от уровня оптимизации
+#if defined(__clang__)
+#define VECTOR_SIMD_TARGET(isa) __attribute__((target(isa)))
+#else
+#define VECTOR_SIMD_TARGET(isa) \
+    __attribute__((target(isa), optimize("tree-vectorize", "vect-cost-model=dynamic")))
+#endif
+#else
+#define VECTOR_SIMD_DISPATCH 0
+#define VECTOR_SIMD_INLINE inline
+#endif
+
+// Встроенные функции AVX-512 в GCC 12 передают в неиспользуемый операнд
+// самоинициализированную переменную, что даёт ложное -Wmaybe-uninitialized.
+// Функции с такими вызовами заключаются в эту пару макросов
+#if VECTOR_SIMD_DISPATCH && !defined(__clang__)
+#define VECTOR_SIMD_AVX512_BEGIN                                  \
+    _Pragma("GCC diagnostic push")                                \
+    _Pragma("GCC diagnostic ignored \"-Wmaybe-uninitialized\"") \
+    _Pragma("GCC diagnostic ignored \"-Wuninitialized\"")
+#define VECTOR_SIMD_AVX512_END _Pragma("GCC diagnostic pop")
+#else
+#define VECTOR_SIMD_AVX512_BEGIN
+#define VECTOR_SIMD_AVX512_END
+#endif
+
+// Ядра поиска и свёртки для массивов чисел. Каждое ядро обрабатывает
+// данные блоками фиксированной длины с независимыми аккумуляторами и
+// без ветвлений внутри блока, поэтому компилятор векторизует цикл.
+// Ядро собирается в нескольких вариантах: базовом (под целевой набор
+// инструкций сборки), AVX2 и AVX-512; при первом вызове выбирается
+// лучший вариант, который поддерживает процессор. Хвост короче блока
+// и поиск позиции внутри найденного блока - скалярные
+namespace simd {
+
+// Каждый следующий вариант включает возможности предыдущего
+enum class Isa {
+    kBaseline,
+    kAvx2,  // вместе с F16C, FMA и POPCNT
+    kAvx512,
+};
+
+// Поддерживает ли процессор вариант isa. Без выбора во время выполнения
+// доступен только базовый
+inline bool Supports(Isa isa) noexcept {
+#if VECTOR_SIMD_DISPATCH
+    switch (isa) {
+        case Isa::kAvx512:
+            return Supports(Isa::kAvx2) && __builtin_cpu_supports("avx512f")
+                && __builtin_cpu_supports("avx512bw");
+        case Isa::kAvx2:
+            return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("f16c")
+                && __builtin_cpu_supports("fma") && __builtin_cpu_supports("popcnt");
+        case Isa::kBaseline:
+            return true;
+    }
+    return false;
+#else
+    return isa == Isa::kBaseline;
+#endif
+}
+
+// Лучший поддерживаемый вариант; определяется один раз
+inline Isa BestIsa() noexcept {
+    static const Isa best = Supports(Isa::kAvx512) ? Isa::kAvx512
+                            : Supports(Isa::kAvx2) ? Isa::kAvx2
+                                                   : Isa::kBaseline;
+    return best;
+}
+
+namespace detail {
+
+// Элементов в блоке: 64 байта для int32_t и float
+template <typename T>
+constexpr size_t kBlock = 64 / sizeof(T) < 8 ? 8 : 64 / sizeof(T);
+
+// Независимых аккумуляторов в свёртках
+constexpr size_t kLanes = 8;
+
+template <typename T>
+using SumType = std::conditional_t<std::is_floating_point_v<T>, double,
+                                   std::conditional_t<std::is_signed_v<T>, int64_t, uint64_t>>;
+
+struct FindKernel {
+    template <typename T>
+    VECTOR_SIMD_INLINE static size_t Run(const T* data, size_t size, T value) noexcept {
+        constexpr size_t kBlockSize = kBlock<T>;
+        size_t i = 0;
+        for (; i + kBlockSize <= size; i += kBlockSize) {
+            // Счётчик вместо логического "или": такую свёртку векторизатор
+            // превращает в сравнение векторов и сложение масок
+            size_t found = 0;
+            for (size_t j = 0; j < kBlockSize; ++j) {
+                found += static_cast<size_t>(data[i + j] == value);
+            }
+            if (found != 0) {
+                break;
+            }
+        }
+        for (; i < size; ++i) {
+            if (data[i] == value) {
+                return i;
+            }
+        }
+        return size;
+    }
+};
+
+struct CountKernel {
+    template <typename T>
+    VECTOR_SIMD_INLINE static size_t Run(const T* data, size_t size, T value) noexcept {
+        size_t count = 0;
+        for (size_t i = 0; i < size; ++i) {
+            count += static_cast<size_t>(data[i] == value);
+        }
+        return count;
+    }
+};
+
+struct MinMaxKernel {
+    template <typename T>
+    VECTOR_SIMD_INLINE static std::pair<T, T> Run(const T* data, size_t size) noexcept {
+        T min[kLanes];
+        T max[kLanes];
+        for (size_t j = 0; j < kLanes; ++j) {
+            min[j] = max[j] = data[0];
+        }
+        size_t i = 0;
+        for (; i + kLanes <= size; i += kLanes) {
+            for (size_t j = 0; j < kLanes; ++j) {
+                min[j] = data[i + j] < min[j] ? data[i + j] : min[j];
+                max[j] = max[j] < data[i + j] ? data[i + j] : max[j];
+            }
+        }
+        for (; i < size; ++i) {
+            min[0] = data[i] < min[0] ? data[i] : min[0];
+            max[0] = max[0] < data[i] ? data[i] : max[0];
+        }
+        for (size_t j = 1; j < kLanes; ++j) {
+            min[0] = min[j] < min[0] ? min[j] : min[0];
+            max[0] = max[0] < max[j] ? max[j] : max[0];
+        }
+        return {min[0], max[0]};
+    }
+};
+
+struct SumKernel {
+    template <typename T>
+    VECTOR_SIMD_INLINE static SumType<T> Run(const T* data, size_t size) noexcept {
+        using Result = SumType<T>;
+        Result sums[kLanes] = {};
+        size_t i = 0;
+        for (; i + kLanes <= size; i += kLanes) {
+            for (size_t j = 0; j < kLanes; ++j) {
+                sums[j] += static_cast<Result>(data[i + j]);
+            }
+        }
+        for (; i < size; ++i) {
+            sums[0] += static_cast<Result>(data[i]);
+        }
+        Result sum{};
+        for (size_t j = 0; j < kLanes; ++j) {
+            sum += sums[j];
+        }
+        return sum;
+    }
+};
+
+struct EqualKernel {
+    template <typename T>
+    VECTOR_SIMD_INLINE static bool Run(const T* left, const T* right, size_t size) noexcept {
+        constexpr size_t kBlockSize = kBlock<T>;
+        size_t i = 0;
+        for (; i + kBlockSize <= size; i += kBlockSize) {
+            size_t differ = 0;
+            for (size_t j = 0; j < kBlockSize; ++j) {
+                differ += static_cast<size_t>(left[i + j] != right[i + j]);
+            }
+            if (differ != 0) {
+                return false;
+            }
+        }
+        for (; i < size; ++i) {
+            if (left[i] != right[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+struct FillKernel {
+    template <typename T>
+    VECTOR_SIMD_INLINE static void Run(T* data, size_t size, T value) noexcept {
+        for (size_t i = 0; i < size; ++i) {
+            data[i] = value;
+        }
+    }
+};
+
+#if VECTOR_SIMD_DISPATCH
+// Тело ядра встраивается в функцию с расширенным набором инструкций
+// и векторизуется уже под него
+template <typename Kernel, typename... Args>
+VECTOR_SIMD_TARGET("avx2,f16c,fma,popcnt") auto RunAvx2(Args... args) noexcept {
+    return Kernel::Run(args...);
+}
+
+template <typename Kernel, typename... Args>
+VECTOR_SIMD_TARGET("avx512f,avx512bw,popcnt") auto RunAvx512(Args... args) noexcept {
+    return Kernel::Run(args...);
+}
+#endif
+
+// Вариант isa должен поддерживаться процессором
+template <typename Kernel, typename... Args>
+auto Run(Isa isa, Args... args) noexcept {
+    assert(Supports(isa));
+#if VECTOR_SIMD_DISPATCH
+    switch (isa) {
+        case Isa::kAvx512:
+            return RunAvx512<Kernel>(args...);
+        case Isa::kAvx2:
+            return RunAvx2<Kernel>(args...);
+        case Isa::kBaseline:
+            break;
+    }
+#endif
+    return Kernel::Run(args...);
+}
+
+}  // namespace detail
+
+// Каждая операция принимает вариант isa явно (для сравнения вариантов
+// между собой) или использует BestIsa(). Тип элементов выводится только
+// из массива, поэтому Find(bytes, 3) ищет байт 3
+
+// Позиция первого элемента, равного value, или values.Size()
+template <typename T>
+size_t Find(Span<const T> values, ::detail::NonDeduced<T> value, Isa isa = BestIsa()) noexcept {
+    static_assert(std::is_arithmetic_v<T>);
+    return detail::Run<detail::FindKernel>(isa, values.Data(), values.Size(), value);
+}
+
+template <typename T>
+bool Contains(Span<const T> values, ::detail::NonDeduced<T> value, Isa isa = BestIsa()) noexcept {
+    return Find(values, value, isa) != values.Size();
+}
+
+template <typename T>
+size_t Count(Span<const T> values, ::detail::NonDeduced<T> value, Isa isa = BestIsa()) noexcept {
+    static_assert(std::is_arithmetic_v<T>);
+    return detail::Run<detail::CountKernel>(isa, values.Data(), values.Size(), value);
+}
+
+// Наименьший и наибольший элементы непустого массива. Значения NaN
+// пропускаются, если массив начинается не с NaN
+template <typename T>
+std::pair<T, T> MinMax(Span<const T> values, Isa isa = BestIsa()) noexcept {
+    static_assert(std::is_arithmetic_v<T>);
+    assert(!values.Empty());
+    return detail::Run<detail::MinMaxKernel>(isa, values.Data(), values.Size());
+}
+
+// Сумма в расширенном типе: int64_t, uint64_t или double. Для чисел
+// с плавающей точкой порядок сложения отличается от последовательного
+template <typename T>
+detail::SumType<T> Sum(Span<const T> values, Isa isa = BestIsa()) noexcept {
+    static_assert(std::is_arithmetic_v<T>);
+    return detail::Run<detail::SumKernel>(isa, values.Data(), values.Size());
+}
+
+template <typename T>
+bool Equal(Span<const T> lhs, Span<const ::detail::NonDeduced<T>> rhs, Isa isa = BestIsa()) noexcept {
+    static_assert(std::is_arithmetic_v<T>);
+    if (lhs.Size() != rhs.Size()) {
+        return false;
+    }
+    return detail::Run<detail::EqualKernel>(isa, lhs.Data(), rhs.Data(), lhs.Size());
+}
+
+template <typename T>
+void Fill(Span<T> values, ::detail::NonDeduced<T> value, Isa isa = BestIsa()) noexcept {
+    static_assert(std::is_arithmetic_v<T>);
+    detail::Run<detail::FillKernel>(isa, values.Data(), values.Size(), value);
+}
+
+// Перегрузки для Vector: Span<const T> не выводится из аргумента Vector<T>
+template <typename T>
+size_t Find(const Vector<T>& values, ::detail::NonDeduced<T> value, Isa isa = BestIsa()) noexcept {
+    return Find(Span<const T>(values), value, isa);
+}
+
+template <typename T>
+bool Contains(const Vector<T>& values, ::detail::NonDeduced<T> value, Isa isa = BestIsa()) noexcept {
+    return Contains(Span<const T>(values), value, isa);
+}
+
+template <typename T>
+size_t Count(const Vector<T>& values, ::detail::NonDeduced<T> value, Isa isa = BestIsa()) noexcept {
+    return Count(Span<const T>(values), value, isa);
+}
+
+template <typename T>
+std::pair<T, T> MinMax(const Vector<T>& values, Isa isa = BestIsa()) noexcept {
+    return MinMax(Span<const T>(values), isa);
+}
+
+template <typename T>
+detail::SumType<T> Sum(const Vector<T>& values, Isa isa = BestIsa()) noexcept {
+    return Sum(Span<const T>(values), isa);
+}
+
+template <typename T>
+bool Equal(const Vector<T>& lhs, Span<const ::detail::NonDeduced<T>> rhs, Isa isa = BestIsa()) noexcept {
+    return Equal(Span<const T>(lhs), rhs, isa);
+}
+
+template <typename T>
+void Fill(Vector<T>& values, ::detail::NonDeduced<T> value, Isa isa = BestIsa()) noexcept {
+    Fill(Span<T>(values), value, isa);
+}
+
+}  // namespace simd
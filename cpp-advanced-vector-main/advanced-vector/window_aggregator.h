@@ -0,0 +1,265 @@
+#pragma once
+
+#include "vector.h"
+
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+namespace detail {
+
+template <typename T, typename = void>
+struct IsLessComparable : std::false_type {};
+
+template <typename T>
+struct IsLessComparable<T, std::void_t<decltype(std::declval<const T&>() < std::declval<const T&>())>>
+    : std::true_type {};
+
+template <typename T, typename = void>
+struct IsAddSubtractable : std::false_type {};
+
+template <typename T>
+struct IsAddSubtractable<
+    T, std::void_t<decltype(std::declval<T&>() += std::declval<const T&>()),
+                   decltype(std::declval<T&>() -= std::declval<const T&>())>> : std::true_type {};
+
+// Кольцевой буфер поверх Vector с ёмкостью-степенью двойки. Растёт
+// удвоением, поэтому в окне постоянного размера память после разгона
+// больше не выделяется
+template <typename T>
+class Ring {
+public:
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    bool Empty() const noexcept {
+        return size_ == 0;
+    }
+
+    // Элемент index, считая от самого старого
+    const T& operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return data_[(head_ + index) & (data_.Size() - 1)];
+    }
+
+    const T& Front() const noexcept {
+        return (*this)[0];
+    }
+
+    const T& Back() const noexcept {
+        return (*this)[size_ - 1];
+    }
+
+    void PushBack(const T& value) {
+        if (size_ == data_.Size()) {
+            Grow();
+        }
+        data_[(head_ + size_) & (data_.Size() - 1)] = value;
+        ++size_;
+    }
+
+    void PopFront() noexcept {
+        assert(size_ > 0);
+        head_ = (head_ + 1) & (data_.Size() - 1);
+        --size_;
+    }
+
+    void PopBack() noexcept {
+        assert(size_ > 0);
+        --size_;
+    }
+
+private:
+    void Grow() {
+        Vector<T> data(data_.Size() == 0 ? 8 : data_.Size() * 2);
+        for (size_t i = 0; i < size_; ++i) {
+            data[i] = (*this)[i];
+        }
+        data_.Swap(data);
+        head_ = 0;
+    }
+
+    Vector<T> data_;
+    size_t head_ = 0;
+    size_t size_ = 0;
+};
+
+}  // namespace detail
+
+// Агрегаты по скользящему окну за амортизированное O(1) на операцию:
+// минимум и максимум - через монотонные очереди номеров отсчётов
+// (если у T есть <), сумма - накопительно (если у T есть += и -=),
+// свёртка произвольной ассоциативной операцией Op - через две стопки
+// (старая часть окна хранит свёртки суффиксов, новая - одну свёртку).
+// Окно задаётся числом отсчётов (ByCount) или длительностью
+// (ByDuration): тогда в окне отсчёты с отметками времени
+// в (now - duration, now]
+template <typename T, typename Op = std::plus<T>>
+class WindowAggregator {
+public:
+    static WindowAggregator ByCount(size_t count, Op op = Op()) {
+        assert(count > 0);
+        return WindowAggregator(count, 0, std::move(op));
+    }
+
+    static WindowAggregator ByDuration(int64_t duration, Op op = Op()) {
+        assert(duration > 0);
+        return WindowAggregator(0, duration, std::move(op));
+    }
+
+    size_t Size() const noexcept {
+        return samples_.Size();
+    }
+
+    bool Empty() const noexcept {
+        return samples_.Empty();
+    }
+
+    // Отметки времени не должны убывать; для окна по числу отсчётов
+    // отметка не используется
+    void Push(const T& value, int64_t timestamp = 0) {
+        assert(samples_.Empty() || samples_.Back().timestamp <= timestamp);
+        const uint64_t sequence = evicted_ + samples_.Size();
+        samples_.PushBack(Sample{value, timestamp});
+        if constexpr (kOrdered) {
+            while (!min_.Empty() && !(Value(min_.Back()) < value)) {
+                min_.PopBack();
+            }
+            min_.PushBack(sequence);
+            while (!max_.Empty() && !(value < Value(max_.Back()))) {
+                max_.PopBack();
+            }
+            max_.PushBack(sequence);
+        } else {
+            (void)sequence;
+        }
+        if constexpr (kSummable) {
+            sum_ += value;
+        }
+        back_fold_ = samples_.Size() == front_folds_.Size() + 1 ? value : op_(back_fold_, value);
+
+        if (count_ != 0) {
+            if (samples_.Size() > count_) {
+                EvictOldest();
+            }
+        } else {
+            Advance(timestamp);
+        }
+    }
+
+    // Вытесняет отсчёты, вышедшие из окна к моменту now
+    void Advance(int64_t now) {
+        assert(duration_ > 0);
+        while (!samples_.Empty() && samples_.Front().timestamp <= now - duration_) {
+            EvictOldest();
+        }
+    }
+
+    const T& Min() const noexcept {
+        static_assert(kOrdered, "Min requires operator<");
+        assert(!Empty());
+        return Value(min_.Front());
+    }
+
+    const T& Max() const noexcept {
+        static_assert(kOrdered, "Max requires operator<");
+        assert(!Empty());
+        return Value(max_.Front());
+    }
+
+    // Для чисел с плавающей точкой вычитание вытесненных отсчётов
+    // вносит ошибку округления; сумма пересчитывается заново при каждой
+    // перестройке старой стопки, поэтому ошибка не копится дольше
+    // одного оборота окна. Сумма без вычитаний - Fold() с std::plus
+    const T& Sum() const noexcept {
+        static_assert(kSummable, "Sum requires operators += and -=");
+        return sum_;
+    }
+
+    // Op(x_oldest, ..., x_newest) в порядке поступления
+    T Fold() const {
+        assert(!Empty());
+        if (front_folds_.Size() == 0) {
+            return back_fold_;
+        }
+        const T& front = front_folds_[front_folds_.Size() - 1];
+        return samples_.Size() == front_folds_.Size() ? front : op_(front, back_fold_);
+    }
+
+private:
+    static constexpr bool kOrdered = detail::IsLessComparable<T>::value;
+    static constexpr bool kSummable = detail::IsAddSubtractable<T>::value;
+
+    struct Sample {
+        T value;
+        int64_t timestamp;
+    };
+
+    WindowAggregator(size_t count, int64_t duration, Op op)
+        : op_(std::move(op))
+        , count_(count)
+        , duration_(duration) {
+    }
+
+    const T& Value(uint64_t sequence) const noexcept {
+        return samples_[static_cast<size_t>(sequence - evicted_)].value;
+    }
+
+    void EvictOldest() {
+        if (front_folds_.Size() == 0) {
+            Flip();
+            if constexpr (kSummable) {
+                ResetSum();
+            }
+        } else if constexpr (kSummable) {
+            sum_ -= samples_.Front().value;
+        }
+        front_folds_.PopBack();
+        if constexpr (kOrdered) {
+            if (min_.Front() == evicted_) {
+                min_.PopFront();
+            }
+            if (max_.Front() == evicted_) {
+                max_.PopFront();
+            }
+        }
+        samples_.PopFront();
+        ++evicted_;
+    }
+
+    // Переносит всё окно в старую стопку: вершина - свёртка всего окна,
+    // ниже - свёртки всё более коротких суффиксов
+    void Flip() {
+        for (size_t i = samples_.Size(); i-- > 0;) {
+            const T& value = samples_[i].value;
+            if (front_folds_.Size() == 0) {
+                front_folds_.PushBack(value);
+            } else {
+                front_folds_.PushBack(op_(value, front_folds_[front_folds_.Size() - 1]));
+            }
+        }
+    }
+
+    // Сумма всех отсчётов, кроме вытесняемого самого старого
+    void ResetSum() {
+        T sum{};
+        for (size_t i = 1; i < samples_.Size(); ++i) {
+            sum += samples_[i].value;
+        }
+        sum_ = std::move(sum);
+    }
+
+    detail::Ring<Sample> samples_;
+    detail::Ring<uint64_t> min_;
+    detail::Ring<uint64_t> max_;
+    Vector<T> front_folds_;
+    T back_fold_{};
+    T sum_{};
+    uint64_t evicted_ = 0;
+    Op op_;
+    size_t count_ = 0;
+    int64_t duration_ = 0;
+};